@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "border.hpp"
+
+namespace f2d {
+
+static const char *borderNames[] = {"constant", "replicate", "reflect-101"};
+
+const char *borderName(BorderMode mode) { return borderNames[(int)mode]; }
+
+bool parseBorder(const std::string &name, BorderMode *mode) {
+    for (int i = 0; i < 3; i++) {
+        if (name == borderNames[i]) {
+            *mode = (BorderMode)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace f2d
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+
+namespace f2d {
+
+/*
+ * What a filter window reads past the edge of the frame. CONSTANT reads
+ * zero (cv::BORDER_CONSTANT, the PL kernel), REPLICATE repeats the edge
+ * sample (cv::BORDER_REPLICATE, the AIE graph) and REFLECT_101 mirrors
+ * around it without repeating it (cv::BORDER_REFLECT_101).
+ */
+enum class BorderMode { CONSTANT, REPLICATE, REFLECT_101 };
+
+const char *borderName(BorderMode mode);
+
+/* "constant", "replicate" or "reflect-101" */
+bool parseBorder(const std::string &name, BorderMode *mode);
+
+/*
+ * Sample read for position i of a line of n samples, i at most one past
+ * either end; -1 when it reads as zero.
+ */
+inline int borderIndex(int i, int n, BorderMode mode) {
+    if (i >= 0 && i < n)
+        return i;
+    switch (mode) {
+    case BorderMode::CONSTANT:
+        return -1;
+    case BorderMode::REPLICATE:
+        return i < 0 ? 0 : n - 1;
+    case BorderMode::REFLECT_101:
+        if (n == 1)
+            return 0;
+        return i < 0 ? -i : 2 * n - 2 - i;
+    }
+    return -1;
+}
+
+} // namespace f2d
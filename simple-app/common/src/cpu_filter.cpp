@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpu_filter.hpp"
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace f2d {
+
+/* Set the border sample on each side of a line padded by one sample */
+static void padLine(int16_t *line, int width, BorderMode border) {
+    int left = borderIndex(-1, width, border);
+    int right = borderIndex(width, width, border);
+    line[0] = left < 0 ? 0 : line[left + 1];
+    line[width + 1] = right < 0 ? 0 : line[right + 1];
+}
+
+/*
+ * Gather the luma samples of one row into a line padded with one border
+ * sample on each side; a null row is outside the frame and reads as zero.
+ */
+static void loadLumaLine(const uint8_t *row, int width, int step,
+                         BorderMode border, int16_t *line) {
+    if (row == nullptr) {
+        std::fill(line, line + width + 2, 0);
+        return;
+    }
+    for (int x = 0; x < width; x++)
+        line[x + 1] = row[step * x];
+    padLine(line, width, border);
+}
+
+/* True if no partial sum of the window of 8 bit samples overflows int16 */
+static bool fitsInt16(const int16_t taps[FILTER_TAPS]) {
+    int sum = 0;
+    for (int i = 0; i < FILTER_TAPS; i++)
+        sum += abs(taps[i]);
+    return sum * 255 <= INT16_MAX;
+}
+
+/*
+ * Saturated 3x3 convolution of three padded lines into width samples. The
+ * lines carry their border, so every output sample is computed alike.
+ */
+static void convolveLine(const int16_t *const lines[3], int width,
+                         const int16_t taps[FILTER_TAPS], int16_t *out) {
+    int x = 0;
+#ifdef __SSE2__
+    if (fitsInt16(taps)) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i max = _mm_set1_epi16(255);
+        __m128i t[FILTER_TAPS];
+        for (int i = 0; i < FILTER_TAPS; i++)
+            t[i] = _mm_set1_epi16(taps[i]);
+        for (; x + 8 <= width; x += 8) {
+            __m128i acc = zero;
+            for (int j = 0; j < 3; j++) {
+                const int16_t *l = lines[j] + x;
+                for (int k = 0; k < 3; k++)
+                    acc = _mm_add_epi16(
+                        acc,
+                        _mm_mullo_epi16(
+                            _mm_loadu_si128((const __m128i *)(l + k)),
+                            t[j * 3 + k]));
+            }
+            acc = _mm_min_epi16(_mm_max_epi16(acc, zero), max);
+            _mm_storeu_si128((__m128i *)(out + x), acc);
+        }
+    }
+#endif
+    for (; x < width; x++) {
+        int acc = 0;
+        for (int j = 0; j < 3; j++) {
+            const int16_t *l = lines[j] + x;
+            acc += l[0] * taps[j * 3] + l[1] * taps[j * 3 + 1] +
+                   l[2] * taps[j * 3 + 2];
+        }
+        out[x] = (int16_t)std::min(std::max(acc, 0), 255);
+    }
+}
+
+/* Write filtered luma of one row, in YUYV next to the source chroma */
+static void storeLumaRow(const int16_t *luma, const uint8_t *in, int width,
+                         int step, uint8_t *out) {
+    if (step == 1) {
+        for (int x = 0; x < width; x++)
+            out[x] = (uint8_t)luma[x];
+        return;
+    }
+    for (int x = 0; x < width; x++) {
+        out[2 * x] = (uint8_t)luma[x];
+        out[2 * x + 1] = in[2 * x + 1];
+    }
+}
+
+void filterRows(const uint8_t *src, uint8_t *dst, int width, int height,
+                PixelFormat fmt, const int16_t taps[FILTER_TAPS], int rowBegin,
+                int rowEnd, BorderMode border) {
+    int step = lumaStep(fmt);
+    size_t stride = (size_t)width * step;
+    std::vector<int16_t> buf(4 * (width + 2));
+    int16_t *lines[3] = {buf.data(), buf.data() + (width + 2),
+                         buf.data() + 2 * (width + 2)};
+    int16_t *res = buf.data() + 3 * (width + 2);
+
+    rowBegin = std::max(rowBegin, 0);
+    rowEnd = std::min(rowEnd, height);
+
+    // rows past the top and bottom edge map into the frame or to nothing
+    auto rowPtr = [&](int r) -> const uint8_t * {
+        int i = borderIndex(r, height, border);
+        return i < 0 ? nullptr : src + i * stride;
+    };
+
+    for (int r = rowBegin; r < rowEnd; r++) {
+        if (r == rowBegin) {
+            loadLumaLine(rowPtr(r - 1), width, step, border, lines[0]);
+            loadLumaLine(rowPtr(r), width, step, border, lines[1]);
+        } else {
+            std::rotate(lines, lines + 1, lines + 3);
+        }
+        loadLumaLine(rowPtr(r + 1), width, step, border, lines[2]);
+
+        convolveLine(lines, width, taps, res);
+        storeLumaRow(res, src + r * stride, width, step, dst + r * stride);
+    }
+}
+
+namespace {
+
+/*
+ * Rows streaming through the stages of filterChain(). Stage s keeps its
+ * last three input rows, row k in slot k % 3, and emits its output row r
+ * once it holds row r + 1, or at the bottom row r itself. The rows its
+ * window reads after border mapping are then all in the slots. The output
+ * row enters stage s + 1, or from the last stage the destination frame.
+ */
+class ChainStream {
+  public:
+    ChainStream(const uint8_t *src, uint8_t *dst, int width, int height,
+                PixelFormat fmt, const int16_t *taps, int stages,
+                BorderMode border)
+        : mSrc(src), mDst(dst), mWidth(width), mHeight(height),
+          mStep(lumaStep(fmt)), mTaps(taps), mStages(stages),
+          mBorder(border), mBuf((4 * stages + 1) * (width + 2), 0) {}
+
+    /* Row k of the input of stage s, a line padded for the border */
+    void feed(int s, int k, const int16_t *line) {
+        std::copy(line, line + mWidth + 2, slot(s, k % 3));
+        if (k >= 1)
+            emit(s, k - 1);
+        if (k == mHeight - 1)
+            emit(s, k);
+    }
+
+  private:
+    int16_t *slot(int s, int i) {
+        return mBuf.data() + (4 * s + i) * (mWidth + 2);
+    }
+    int16_t *outLine(int s) { return slot(s, 3); }
+    const int16_t *zeroLine() { return slot(mStages, 0); }
+
+    void emit(int s, int r) {
+        size_t stride = (size_t)mWidth * mStep;
+        const int16_t *lines[3];
+        for (int j = 0; j < 3; j++) {
+            int i = borderIndex(r + j - 1, mHeight, mBorder);
+            lines[j] = i < 0 ? zeroLine() : slot(s, i % 3);
+        }
+        int16_t *out = outLine(s);
+        convolveLine(lines, mWidth, mTaps + s * FILTER_TAPS, out + 1);
+        if (s == mStages - 1) {
+            storeLumaRow(out + 1, mSrc + r * stride, mWidth, mStep,
+                         mDst + r * stride);
+            return;
+        }
+        padLine(out, mWidth, mBorder);
+        feed(s + 1, r, out);
+    }
+
+    const uint8_t *mSrc;
+    uint8_t *mDst;
+    int mWidth;
+    int mHeight;
+    int mStep;
+    const int16_t *mTaps;
+    int mStages;
+    BorderMode mBorder;
+    std::vector<int16_t> mBuf; // 3 slots + 1 output line per stage, zeros
+};
+
+} // namespace
+
+void filterChain(const uint8_t *src, uint8_t *dst, int width, int height,
+                 PixelFormat fmt, const int16_t *taps, int stages,
+                 BorderMode border) {
+    int step = lumaStep(fmt);
+    size_t stride = (size_t)width * step;
+    std::vector<int16_t> line(width + 2);
+    ChainStream stream(src, dst, width, height, fmt, taps, stages, border);
+
+    for (int r = 0; r < height; r++) {
+        loadLumaLine(src + r * stride, width, step, border, line.data());
+        stream.feed(0, r, line.data());
+    }
+}
+
+void copyChroma(const uint8_t *src, uint8_t *dst, PixelFormat fmt, int width,
+                int height) {
+    if (fmt != PixelFormat::NV12 && fmt != PixelFormat::NV16)
+        return;
+    size_t luma = (size_t)width * height;
+    memcpy(dst + luma, src + luma, frameBytes(fmt, width, height) - luma);
+}
+
+} // namespace f2d
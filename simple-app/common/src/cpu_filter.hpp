@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "border.hpp"
+#include "pixel_format.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace f2d {
+
+/* Rows/columns a 3x3 window reaches past the sample it produces */
+static constexpr int FILTER_HALO = 1;
+static constexpr int FILTER_TAPS = 9;
+
+/*
+ * CPU equivalent of the filter2d accelerators.
+ *
+ * Filters the luma samples of output rows [rowBegin, rowEnd) with a 3x3
+ * kernel, samples outside the frame are read as the border mode says and
+ * results saturate to 8 bit. For YUYV the chroma bytes of the rows are
+ * copied through; for NV12, NV16 and GRAY8 only the Y plane at the start
+ * of the frame is read and written, see copyChroma(). Only the requested
+ * rows plus their one-row halo are read, in every border mode, so disjoint
+ * row ranges can be processed independently and in any order.
+ *
+ * The border is resolved while rows are gathered into padded lines, the
+ * convolution of the lines then runs without any edge test, on SSE2 in
+ * 16 bit lanes whenever sum(|tap|) * 255 fits in int16 and in 32 bit
+ * scalar code otherwise.
+ */
+void filterRows(const uint8_t *src, uint8_t *dst, int width, int height,
+                PixelFormat fmt, const int16_t taps[FILTER_TAPS], int rowBegin,
+                int rowEnd, BorderMode border = BorderMode::CONSTANT);
+
+inline void filterFrame(const uint8_t *src, uint8_t *dst, int width,
+                        int height, PixelFormat fmt,
+                        const int16_t taps[FILTER_TAPS],
+                        BorderMode border = BorderMode::CONSTANT) {
+    filterRows(src, dst, width, height, fmt, taps, 0, height, border);
+}
+
+/* Pass the UV plane of NV12/NV16 frames through, no-op for other formats */
+void copyChroma(const uint8_t *src, uint8_t *dst, PixelFormat fmt, int width,
+                int height);
+
+/*
+ * Apply a chain of 3x3 filters (stages x FILTER_TAPS taps, first stage
+ * first) to a frame in one pass. Rows stream through all stages at once,
+ * so only three lines per stage stay live instead of one intermediate
+ * frame per stage. Every stage saturates to 8 bit and applies the border
+ * mode to its own input, exactly as when the filters run one after another.
+ */
+void filterChain(const uint8_t *src, uint8_t *dst, int width, int height,
+                 PixelFormat fmt, const int16_t *taps, int stages,
+                 BorderMode border = BorderMode::CONSTANT);
+
+} // namespace f2d
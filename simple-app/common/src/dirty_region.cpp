@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dirty_region.hpp"
+#include "cpu_filter.hpp"
+#include <algorithm>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace f2d {
+
+bool bytesDiffer(const uint8_t *a, const uint8_t *b, size_t n) {
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 64 <= n; i += 64) {
+        __m128i d0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(a + i)),
+                                   _mm_loadu_si128((const __m128i *)(b + i)));
+        __m128i d1 =
+            _mm_xor_si128(_mm_loadu_si128((const __m128i *)(a + i + 16)),
+                          _mm_loadu_si128((const __m128i *)(b + i + 16)));
+        __m128i d2 =
+            _mm_xor_si128(_mm_loadu_si128((const __m128i *)(a + i + 32)),
+                          _mm_loadu_si128((const __m128i *)(b + i + 32)));
+        __m128i d3 =
+            _mm_xor_si128(_mm_loadu_si128((const __m128i *)(a + i + 48)),
+                          _mm_loadu_si128((const __m128i *)(b + i + 48)));
+        __m128i acc = _mm_or_si128(_mm_or_si128(d0, d1), _mm_or_si128(d2, d3));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(acc, zero)) != 0xFFFF)
+            return true;
+    }
+#endif
+    return memcmp(a + i, b + i, n - i) != 0;
+}
+
+DirtyRegionTracker::DirtyRegionTracker(int height, size_t rowBytes,
+                                       int stripeRows)
+    : mHeight(height), mRowBytes(rowBytes),
+      mStripeRows(std::max(stripeRows, 1)), mPrimed(false),
+      mPrev((size_t)height * rowBytes) {}
+
+RowBand DirtyRegionTracker::inputBand(const RowBand &out) const {
+    return {std::max(out.begin - FILTER_HALO, 0),
+            std::min(out.end + FILTER_HALO, mHeight)};
+}
+
+const std::vector<RowBand> &DirtyRegionTracker::update(const uint8_t *frame) {
+    mBands.clear();
+
+    if (!mPrimed) {
+        memcpy(mPrev.data(), frame, mPrev.size());
+        mBands.push_back({0, mHeight});
+        mPrimed = true;
+    } else {
+        for (int s = 0; s < mHeight; s += mStripeRows) {
+            int e = std::min(s + mStripeRows, mHeight);
+            size_t off = (size_t)s * mRowBytes;
+            size_t len = (size_t)(e - s) * mRowBytes;
+            if (!bytesDiffer(frame + off, mPrev.data() + off, len))
+                continue;
+            memcpy(mPrev.data() + off, frame + off, len);
+
+            RowBand band = {std::max(s - FILTER_HALO, 0),
+                            std::min(e + FILTER_HALO, mHeight)};
+            if (!mBands.empty() && band.begin <= mBands.back().end)
+                mBands.back().end = band.end;
+            else
+                mBands.push_back(band);
+        }
+    }
+
+    mLast = DirtyStats();
+    mLast.frames = 1;
+    mLast.skippedFrames = mBands.empty() ? 1 : 0;
+    mLast.fullRows = mHeight;
+    mLast.fullBytes = 2 * (uint64_t)mHeight * mRowBytes;
+    for (const RowBand &b : mBands) {
+        mLast.filteredRows += b.rows();
+        mLast.movedBytes +=
+            (uint64_t)(inputBand(b).rows() + b.rows()) * mRowBytes;
+    }
+
+    mStats.frames += mLast.frames;
+    mStats.skippedFrames += mLast.skippedFrames;
+    mStats.fullRows += mLast.fullRows;
+    mStats.filteredRows += mLast.filteredRows;
+    mStats.fullBytes += mLast.fullBytes;
+    mStats.movedBytes += mLast.movedBytes;
+    return mBands;
+}
+
+} // namespace f2d
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace f2d {
+
+/* Half-open range of frame rows [begin, end) */
+struct RowBand {
+    int begin;
+    int end;
+
+    int rows() const { return end - begin; }
+};
+
+/*
+ * Accounting of the incremental path against full-frame passes: output rows
+ * filtered, and the bytes a device filtering them would have uploaded plus
+ * read back, which only apply when a device does the filtering
+ */
+struct DirtyStats {
+    uint64_t frames = 0;
+    uint64_t skippedFrames = 0;
+    uint64_t fullRows = 0;      // rows full-frame passes would have filtered
+    uint64_t filteredRows = 0;  // rows of the dirty bands
+    uint64_t fullBytes = 0;     // bytes full-frame passes would have moved
+    uint64_t movedBytes = 0;    // bytes of the dirty bands and their halo
+    uint64_t savedBytes() const { return fullBytes - movedBytes; }
+};
+
+/*
+ * Tracks which output rows of a frame sequence need refreshing.
+ *
+ * Each frame is compared against the previous one in horizontal stripes of
+ * stripeRows rows. Changed stripes are widened by the filter halo, so the
+ * returned bands cover every output row whose 3x3 window touched a changed
+ * pixel; all other output rows may be reused from the previous result. This
+ * holds for every border mode, as the replicated or reflected rows of an
+ * edge row are within the halo too. The first frame is reported dirty as a
+ * whole, an identical frame yields no bands.
+ */
+class DirtyRegionTracker {
+  public:
+    DirtyRegionTracker(int height, size_t rowBytes, int stripeRows);
+
+    const std::vector<RowBand> &update(const uint8_t *frame);
+
+    /* Input rows a band of output rows has to be computed from */
+    RowBand inputBand(const RowBand &out) const;
+
+    const DirtyStats &stats() const { return mStats; }
+    const DirtyStats &lastFrameStats() const { return mLast; }
+
+  private:
+    int mHeight;
+    size_t mRowBytes;
+    int mStripeRows;
+    bool mPrimed;
+    std::vector<uint8_t> mPrev;
+    std::vector<RowBand> mBands;
+    DirtyStats mStats;
+    DirtyStats mLast;
+};
+
+/* True if the n bytes at a and b differ anywhere (SSE2 when available) */
+bool bytesDiffer(const uint8_t *a, const uint8_t *b, size_t n);
+
+} // namespace f2d
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "filter_presets.hpp"
+
+namespace f2d {
+
+const FilterPreset filterPresets[] = {
+    {"Horizontal-Gradient", {-1, -1, -1, 0, 0, 0, 1, 1, 1}},
+    {"Emboss", {-2, -1, 0, -1, 1, 1, 0, 1, 2}},
+    {"Edge", {0, 1, 0, 1, -4, 1, 0, 1, 0}},
+    {"Blur", {1, 1, 1, 1, -7, 1, 1, 1, 1}},
+    {"Identity", {0, 0, 0, 0, 1, 0, 0, 0, 0}},
+    {"Horizontal-Sobel", {1, 2, 1, 0, 0, 0, -1, -2, -1}},
+};
+
+const int filterPresetCount =
+    sizeof(filterPresets) / sizeof(filterPresets[0]);
+
+const FilterPreset aieEdgeFilter = {"AIE-Edge", {0, 1, 0, 1, -4, 1, 0, 1, 0}};
+
+const FilterPreset *findFilterPreset(const std::string &name) {
+    for (int i = 0; i < filterPresetCount; i++) {
+        if (name == filterPresets[i].name)
+            return &filterPresets[i];
+    }
+    return nullptr;
+}
+
+} // namespace f2d
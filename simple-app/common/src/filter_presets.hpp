@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "cpu_filter.hpp"
+#include <stdint.h>
+#include <string>
+
+namespace f2d {
+
+/* Named 3x3 coefficient set of the example applications */
+struct FilterPreset {
+    const char *name;
+    int16_t taps[FILTER_TAPS];
+};
+
+/* The selectable filters of the PL host */
+extern const FilterPreset filterPresets[];
+extern const int filterPresetCount;
+
+/* The fixed edge filter of the AIE graph */
+extern const FilterPreset aieEdgeFilter;
+
+/* Preset of the given name, null if there is none */
+const FilterPreset *findFilterPreset(const std::string &name);
+
+} // namespace f2d
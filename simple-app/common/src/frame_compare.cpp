@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "frame_compare.hpp"
+#include <stdlib.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace f2d {
+
+size_t compareFrames(const uint8_t *out, const uint8_t *ref, size_t bytes,
+                     int tolerance) {
+    size_t errCount = 0;
+    size_t i = 0;
+
+#ifdef __SSE2__
+    // |out - ref| > tolerance, 16 bytes at a time
+    const __m128i tol = _mm_set1_epi8((char)tolerance);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(out + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(ref + i));
+        __m128i diff = _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+        __m128i ok = _mm_cmpeq_epi8(_mm_subs_epu8(diff, tol), zero);
+        errCount += 16 - __builtin_popcount(_mm_movemask_epi8(ok));
+    }
+#endif
+    for (; i < bytes; i++) {
+        if (abs(out[i] - ref[i]) > tolerance)
+            errCount++;
+    }
+    return errCount;
+}
+
+void reportCompare(std::ostream &os, size_t errCount, size_t bytes) {
+    if (errCount)
+        os << "Result: Test failed " << errCount << "/" << bytes
+           << " unmatched Bytes" << std::endl;
+    else
+        os << "Result: Test Passed" << std::endl;
+}
+
+} // namespace f2d
@@ -0,0 +1,32 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <ostream>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace f2d {
+
+/* Number of bytes of two buffers differing by more than tolerance */
+size_t compareFrames(const uint8_t *out, const uint8_t *ref, size_t bytes,
+                     int tolerance = 1);
+
+/* Print the outcome of a comparison against the reference */
+void reportCompare(std::ostream &os, size_t errCount, size_t bytes);
+
+} // namespace f2d
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "frame_io.hpp"
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+namespace f2d {
+
+FrameSource::FrameSource(const std::string &path, bool video)
+    : mOpened(false) {
+    if (video) {
+        mOpened = mVideo.open(path);
+    } else {
+        mImage = cv::imread(path, cv::IMREAD_COLOR);
+        mOpened = mImage.data != NULL;
+    }
+}
+
+bool FrameSource::read(cv::Mat &bgr) {
+    if (mVideo.isOpened())
+        return mVideo.read(bgr);
+    if (mImage.empty())
+        return false;
+    bgr = mImage;
+    mImage.release();
+    return true;
+}
+
+void convertBgrFrame(const cv::Mat &bgr, uint8_t *dst, PixelFormat fmt,
+                     int width, int height) {
+    cv::Mat img = bgr;
+
+    if (img.cols != width || img.rows != height)
+        cv::resize(bgr, img, cv::Size(width, height), 0, 0, cv::INTER_LINEAR);
+    else if (!img.isContinuous())
+        img = bgr.clone();
+    convertFrame(img.data, PixelFormat::BGR, dst, fmt, width, height);
+}
+
+bool dumpFrame(const std::string &path, const uint8_t *frame,
+               PixelFormat fmt, int width, int height) {
+    cv::Mat bgr(height, width, CV_8UC3);
+
+    convertFrame(frame, fmt, bgr.data, PixelFormat::BGR, width, height);
+    return cv::imwrite(path, bgr);
+}
+
+} // namespace f2d
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "pixel_format.hpp"
+#include <opencv2/core/core.hpp>
+#include <opencv2/videoio.hpp>
+#include <stdint.h>
+#include <string>
+
+namespace f2d {
+
+/*
+ * Decoded BGR frames of a video file or image sequence (e.g.
+ * "frames/img_%04d.jpg"), or of a single image that reads as a stream of
+ * one frame.
+ */
+class FrameSource {
+  public:
+    FrameSource(const std::string &path, bool video);
+
+    bool isOpened() const { return mOpened; }
+    /* Next frame, false at the end of the stream */
+    bool read(cv::Mat &bgr);
+
+  private:
+    cv::VideoCapture mVideo;
+    cv::Mat mImage;
+    bool mOpened;
+};
+
+/* Resize a BGR image to width x height and convert it into dst */
+void convertBgrFrame(const cv::Mat &bgr, uint8_t *dst, PixelFormat fmt,
+                     int width, int height);
+
+/* Write a frame as a BGR image, the format follows the path's extension */
+bool dumpFrame(const std::string &path, const uint8_t *frame,
+               PixelFormat fmt, int width, int height);
+
+} // namespace f2d
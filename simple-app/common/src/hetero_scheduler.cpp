@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hetero_scheduler.hpp"
+#include "cpu_filter.hpp"
+#include "metrics.hpp"
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+
+namespace f2d {
+
+CpuWorker::CpuWorker(const int16_t taps[9], PixelFormat fmt, BorderMode border)
+    : mFormat(fmt), mBorder(border) {
+    memcpy(mTaps, taps, sizeof(mTaps));
+}
+
+void CpuWorker::filterBand(const uint8_t *src, uint8_t *dst, int width,
+                           int height, RowBand band) {
+    filterRows(src, dst, width, height, mFormat, mTaps, band.begin, band.end,
+               mBorder);
+}
+
+StandInDevice::StandInDevice(const int16_t taps[9], int latencyUs,
+                             PixelFormat fmt, BorderMode border)
+    : CpuWorker(taps, fmt, border), mLatencyUs(latencyUs) {}
+
+void StandInDevice::filterBand(const uint8_t *src, uint8_t *dst, int width,
+                               int height, RowBand band) {
+    auto due = std::chrono::steady_clock::now() +
+               std::chrono::microseconds(mLatencyUs);
+    CpuWorker::filterBand(src, dst, width, height, band);
+    std::this_thread::sleep_until(due);
+}
+
+HeteroScheduler::HeteroScheduler(const std::vector<FilterWorker *> &workers,
+                                 int granuleRows, double alpha)
+    : mSlots(workers.size()), mGranule(std::max(granuleRows, 1)),
+      mAlpha(alpha), mSrc(nullptr), mDst(nullptr), mWidth(0), mHeight(0),
+      mOutstanding(0), mStop(false) {
+    for (size_t i = 0; i < mSlots.size(); i++) {
+        Slot &s = mSlots[i];
+        s.worker = workers[i];
+        s.band = {0, 0};
+        s.pending = false;
+        s.rowsPerSec = 0;
+        s.rowsDone = 0;
+        s.busySec = 0;
+    }
+    for (size_t i = 0; i < mSlots.size(); i++)
+        mSlots[i].thread = std::thread(&HeteroScheduler::workerLoop, this, i);
+}
+
+HeteroScheduler::~HeteroScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mWork.notify_all();
+    for (Slot &s : mSlots)
+        s.thread.join();
+}
+
+std::vector<int> HeteroScheduler::split(int rows) const {
+    size_t n = mSlots.size();
+    std::vector<int> shares(n, 0);
+    bool measured = true;
+    double total = 0;
+    size_t best = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        measured = measured && mSlots[i].rowsPerSec > 0;
+        total += mSlots[i].rowsPerSec;
+        if (mSlots[i].rowsPerSec > mSlots[best].rowsPerSec)
+            best = i;
+    }
+
+    int minRows = rows >= (int)n * mGranule ? mGranule : 0;
+    int sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        double w = measured ? mSlots[i].rowsPerSec / total : 1.0 / n;
+        int share = (int)(rows * w) / mGranule * mGranule;
+        shares[i] = std::max(share, minRows);
+        sum += shares[i];
+    }
+    // the granule minimum may overshoot, take it back from the largest
+    while (sum > rows) {
+        size_t big = std::max_element(shares.begin(), shares.end()) -
+                     shares.begin();
+        int d = std::min(sum - rows, shares[big] - minRows);
+        shares[big] -= d;
+        sum -= d;
+    }
+    shares[best] += rows - sum;
+    return shares;
+}
+
+void HeteroScheduler::workerLoop(size_t idx) {
+    Slot &slot = mSlots[idx];
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    for (;;) {
+        mWork.wait(lock, [&] { return mStop || slot.pending; });
+        if (mStop)
+            return;
+        RowBand band = slot.band;
+        lock.unlock();
+
+        auto t0 = std::chrono::steady_clock::now();
+        slot.worker->filterBand(mSrc, mDst, mWidth, mHeight, band);
+        std::chrono::duration<double> dt =
+            std::chrono::steady_clock::now() - t0;
+
+        lock.lock();
+        double rate = band.rows() / std::max(dt.count(), 1e-9);
+        slot.rowsPerSec = slot.rowsPerSec > 0
+                              ? (1 - mAlpha) * slot.rowsPerSec + mAlpha * rate
+                              : rate;
+        slot.rowsDone += band.rows();
+        slot.busySec += dt.count();
+        slot.pending = false;
+        hostMetrics().workerBands.add(-1);
+        if (--mOutstanding == 0)
+            mDone.notify_all();
+    }
+}
+
+void HeteroScheduler::run(const uint8_t *src, uint8_t *dst, int width,
+                          int height, RowBand region) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    std::vector<int> shares = split(region.rows());
+    int row = region.begin;
+
+    mSrc = src;
+    mDst = dst;
+    mWidth = width;
+    mHeight = height;
+    for (size_t i = 0; i < mSlots.size(); i++) {
+        mSlots[i].band = {row, row + shares[i]};
+        mSlots[i].pending = shares[i] > 0;
+        mOutstanding += mSlots[i].pending ? 1 : 0;
+        row += shares[i];
+    }
+    if (mOutstanding == 0)
+        return;
+    hostMetrics().workerBands.add(mOutstanding);
+    mWork.notify_all();
+    mDone.wait(lock, [&] { return mOutstanding == 0; });
+}
+
+void HeteroScheduler::printStats(std::ostream &os) const {
+    uint64_t rows = 0;
+    for (const Slot &s : mSlots)
+        rows += s.rowsDone;
+    for (const Slot &s : mSlots)
+        os << "Worker " << s.worker->name() << ": "
+           << (rows ? 100.0 * s.rowsDone / rows : 0.0) << "% of rows, "
+           << s.rowsPerSec << " rows/s, busy " << s.busySec * 1000 << "ms"
+           << std::endl;
+}
+
+} // namespace f2d
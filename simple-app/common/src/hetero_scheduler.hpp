@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "border.hpp"
+#include "dirty_region.hpp"
+#include "pixel_format.hpp"
+#include <condition_variable>
+#include <mutex>
+#include <ostream>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+namespace f2d {
+
+/*
+ * One member of the worker pool. filterBand() produces output rows [band)
+ * of a frame from the complete source frame, reading whatever halo rows it
+ * needs; every worker must produce bit-identical rows, which takes the same
+ * border mode everywhere.
+ */
+class FilterWorker {
+  public:
+    virtual ~FilterWorker() {}
+    virtual const char *name() const = 0;
+    virtual BorderMode border() const { return BorderMode::CONSTANT; }
+    virtual void filterBand(const uint8_t *src, uint8_t *dst, int width,
+                            int height, RowBand band) = 0;
+};
+
+/* CPU implementation, one core per instance */
+class CpuWorker : public FilterWorker {
+  public:
+    explicit CpuWorker(const int16_t taps[9],
+                       PixelFormat fmt = PixelFormat::YUYV,
+                       BorderMode border = BorderMode::CONSTANT);
+    const char *name() const override { return "cpu"; }
+    BorderMode border() const override { return mBorder; }
+    void filterBand(const uint8_t *src, uint8_t *dst, int width, int height,
+                    RowBand band) override;
+
+  private:
+    int16_t mTaps[9];
+    PixelFormat mFormat;
+    BorderMode mBorder;
+};
+
+/*
+ * Stand-in for an accelerator: filters on the CPU, then holds the band for
+ * a fixed latency per launch to model transfer and kernel time.
+ */
+class StandInDevice : public CpuWorker {
+  public:
+    StandInDevice(const int16_t taps[9], int latencyUs,
+                  PixelFormat fmt = PixelFormat::YUYV,
+                  BorderMode border = BorderMode::CONSTANT);
+    const char *name() const override { return "stand-in"; }
+    void filterBand(const uint8_t *src, uint8_t *dst, int width, int height,
+                    RowBand band) override;
+
+  private:
+    int mLatencyUs;
+};
+
+/*
+ * Splits every frame region into one contiguous band per worker, sized in
+ * proportion to each worker's throughput (rows/s), and runs the bands
+ * concurrently on a thread per worker. Throughput is tracked as an
+ * exponential moving average of the observed band latencies, so the split
+ * follows load changes online. Each worker keeps at least one granule of
+ * rows so its estimate stays current.
+ */
+class HeteroScheduler {
+  public:
+    HeteroScheduler(const std::vector<FilterWorker *> &workers,
+                    int granuleRows = 8, double alpha = 0.25);
+    ~HeteroScheduler();
+
+    /* Filter output rows [region) of src into dst, blocks until done */
+    void run(const uint8_t *src, uint8_t *dst, int width, int height,
+             RowBand region);
+
+    void printStats(std::ostream &os) const;
+
+    /* Output rows workers[idx] produced, call between runs */
+    uint64_t rowsDone(size_t idx) const { return mSlots[idx].rowsDone; }
+
+    /* Thread running workers[idx], e.g. to pin it */
+    std::thread &workerThread(size_t idx) { return mSlots[idx].thread; }
+
+  private:
+    struct Slot {
+        FilterWorker *worker;
+        std::thread thread;
+        RowBand band;
+        bool pending;
+        double rowsPerSec; // 0 until the first measurement
+        uint64_t rowsDone;
+        double busySec;
+    };
+
+    void workerLoop(size_t idx);
+    std::vector<int> split(int rows) const;
+
+    std::vector<Slot> mSlots;
+    int mGranule;
+    double mAlpha;
+    const uint8_t *mSrc;
+    uint8_t *mDst;
+    int mWidth;
+    int mHeight;
+    size_t mOutstanding;
+    bool mStop;
+    std::mutex mMutex;
+    std::condition_variable mWork;
+    std::condition_variable mDone;
+};
+
+} // namespace f2d
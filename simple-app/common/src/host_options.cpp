@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "host_options.hpp"
+#include <stdlib.h>
+
+namespace f2d {
+
+HostOptions::HostOptions(const std::string &xclbin)
+    : inputImage("/opt/xilinx/testimg/HD.jpg"), userXclbin(xclbin),
+      format(PixelFormat::YUYV), numaNode(-1), queueDepth(3) {}
+
+int parseHostOption(int argc, char **argv, int i, HostOptions &opts) {
+    std::string arg = argv[i];
+
+    if (i + 1 >= argc || arg.size() != 2 || arg[0] != '-')
+        return 0;
+    std::string value = argv[i + 1];
+    switch (arg[1]) {
+    case 'i':
+        opts.inputImage = value;
+        break;
+    case 'v':
+        opts.inputVideo = value;
+        break;
+    case 'u':
+        opts.userXclbin = value;
+        break;
+    case 'm':
+        opts.metricsFile = value;
+        break;
+    case 'a':
+        opts.coreSets = value;
+        break;
+    case 'p':
+        if (!parseFormat(value, &opts.format) ||
+            opts.format == PixelFormat::BGR)
+            return -1;
+        break;
+    case 'n':
+        opts.numaNode = atoi(value.c_str());
+        break;
+    case 'q':
+        opts.queueDepth = atoi(value.c_str());
+        if (opts.queueDepth < 1)
+            return -1;
+        break;
+    default:
+        return 0;
+    }
+    return 2;
+}
+
+const char *hostOptionsHelp() {
+    return "    -i [image_path]  input image\n"
+           "    -u [xclbin]      accelerator binary\n"
+           "    -v [video_path]  process every frame of a video or image "
+           "sequence\n"
+           "    -p [format]      frame format: YUYV (default), NV12, NV16 or "
+           "GRAY8\n"
+           "    -q [frames]      frames in flight in the pipeline (default "
+           "3)\n"
+           "    -m [file]        publish Prometheus metrics to file, "
+           "rewritten every second\n"
+           "    -n [node]        place buffers and threads on this NUMA node "
+           "instead of the card's\n"
+           "    -a [cores]       core sets per thread role, e.g. "
+           "decode=0:convert=1-3:submit=4:writer=5\n";
+}
+
+} // namespace f2d
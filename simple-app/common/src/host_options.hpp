@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "pixel_format.hpp"
+#include <string>
+
+namespace f2d {
+
+/* Options shared by the host applications */
+struct HostOptions {
+    explicit HostOptions(const std::string &xclbin);
+
+    std::string inputImage;  // -i
+    std::string inputVideo;  // -v, empty for a single image
+    std::string userXclbin;  // -u
+    std::string metricsFile; // -m
+    std::string coreSets;    // -a
+    PixelFormat format;      // -p
+    int numaNode;            // -n, -1 for the node of the card
+    int queueDepth;          // -q, frames in flight
+};
+
+/*
+ * Parse argv[i] if it is one of the shared options. Returns the number of
+ * arguments consumed, 0 for any other argument and -1 for an invalid value.
+ */
+int parseHostOption(int argc, char **argv, int i, HostOptions &opts);
+
+/* Help lines of the shared options */
+const char *hostOptionsHelp();
+
+} // namespace f2d
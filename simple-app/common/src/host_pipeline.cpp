@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "host_pipeline.hpp"
+#include "frame_compare.hpp"
+#include "metrics.hpp"
+#include "reference.hpp"
+#include <chrono>
+#include <iostream>
+
+namespace f2d {
+
+HostPipeline::HostPipeline(FrameSource &source,
+                           const PlacementPolicy &placement, PixelFormat fmt,
+                           int width, int height, size_t slots)
+    : mSource(source), mFormat(fmt), mWidth(width), mHeight(height),
+      mBytes(frameBytes(fmt, width, height)), mSlots(slots),
+      mPipeline(slots, &placement), mRefBorder(BorderMode::CONSTANT),
+      mRef(mBytes), mLastSlot(0), mDecoded(0), mFailedFrames(0) {
+    for (Slot &slot : mSlots) {
+        slot.in.reset(new NodeBuffer(mBytes, placement.node()));
+        slot.out.reset(new NodeBuffer(mBytes, placement.node()));
+    }
+}
+
+void HostPipeline::setFilter(const std::string &name, Filter filter) {
+    mFilterName = name;
+    mFilter = filter;
+}
+
+void HostPipeline::setReference(const int16_t *taps, int stages,
+                                BorderMode border) {
+    mRefTaps.assign(taps, taps + stages * 9);
+    mRefBorder = border;
+}
+
+uint64_t HostPipeline::run() {
+    HostMetrics &stats = hostMetrics();
+
+    mPipeline.setSource("decode", ThreadRole::DECODE, [&](size_t s) {
+        mSlots[s].index = mDecoded++;
+        return mSource.read(mSlots[s].decoded);
+    });
+    mPipeline.addStage("convert", ThreadRole::CONVERT, [&](size_t s) {
+        convertBgrFrame(mSlots[s].decoded, mSlots[s].in->data(), mFormat,
+                        mWidth, mHeight);
+    });
+    mPipeline.addStage(mFilterName, ThreadRole::SUBMIT, [&](size_t s) {
+        auto t0 = std::chrono::steady_clock::now();
+        mFilter(s, mSlots[s].in->data(), mSlots[s].out->data());
+        stats.frameTime.observe(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - t0)
+                .count());
+    });
+    mPipeline.addStage("validate", ThreadRole::WRITER, [&](size_t s) {
+        Slot &slot = mSlots[s];
+
+        stats.frames.add();
+        if (mReport)
+            mReport(s, slot.index);
+        referenceFilter(slot.in->data(), mRef.data(), mWidth, mHeight,
+                        mFormat, mRefTaps.data(), mRefTaps.size() / 9,
+                        mRefBorder);
+        size_t errCount = compareFrames(slot.out->data(), mRef.data(), mBytes);
+        reportCompare(std::cout, errCount, mBytes);
+        if (errCount) {
+            mFailedFrames++;
+            stats.failedFrames.add();
+            stats.mismatchedBytes.add(errCount);
+        }
+        mLastSlot = s;
+    });
+    return mPipeline.run();
+}
+
+void HostPipeline::dumpLast(const std::string &inPath,
+                            const std::string &refPath,
+                            const std::string &outPath) const {
+    const Slot &last = mSlots[mLastSlot];
+
+    dumpFrame(inPath, last.in->data(), mFormat, mWidth, mHeight);
+    dumpFrame(refPath, mRef.data(), mFormat, mWidth, mHeight);
+    dumpFrame(outPath, last.out->data(), mFormat, mWidth, mHeight);
+}
+
+} // namespace f2d
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "border.hpp"
+#include "frame_io.hpp"
+#include "pipeline.hpp"
+#include "pixel_format.hpp"
+#include "placement.hpp"
+#include <functional>
+#include <memory>
+#include <opencv2/core/core.hpp>
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace f2d {
+
+/*
+ * The decode -> convert -> filter -> validate pipeline both hosts run, with
+ * up to slots frames in flight. Frames of the source are resized and
+ * converted into buffers on the node of the placement policy, filtered by
+ * whatever backend the host selected and compared against the OpenCV
+ * reference of the filter chain. The frame, failure and frame time metrics
+ * are updated on the way.
+ */
+class HostPipeline {
+  public:
+    /* Filter the converted frame of a slot, on the submit thread */
+    using Filter =
+        std::function<void(size_t slot, const uint8_t *in, uint8_t *out)>;
+    /* Called on the writer thread with each filtered frame, in order */
+    using Report = std::function<void(size_t slot, int index)>;
+
+    HostPipeline(FrameSource &source, const PlacementPolicy &placement,
+                 PixelFormat fmt, int width, int height, size_t slots);
+    HostPipeline(const HostPipeline &) = delete;
+    HostPipeline &operator=(const HostPipeline &) = delete;
+
+    void setFilter(const std::string &name, Filter filter);
+    /* Reference chain, stages x 9 taps applied with border */
+    void setReference(const int16_t *taps, int stages, BorderMode border);
+    void setReport(Report report) { mReport = report; }
+
+    /* Run once to the end of the source, returns the frames filtered */
+    uint64_t run();
+
+    int failedFrames() const { return mFailedFrames; }
+    void printStats(std::ostream &os) const { mPipeline.printStats(os); }
+
+    /* Write input, reference and output of the last frame as images */
+    void dumpLast(const std::string &inPath, const std::string &refPath,
+                  const std::string &outPath) const;
+
+  private:
+    struct Slot {
+        int index;
+        cv::Mat decoded;
+        std::unique_ptr<NodeBuffer> in;
+        std::unique_ptr<NodeBuffer> out;
+    };
+
+    FrameSource &mSource;
+    PixelFormat mFormat;
+    int mWidth;
+    int mHeight;
+    size_t mBytes;
+    std::vector<Slot> mSlots;
+    Pipeline mPipeline;
+    std::string mFilterName;
+    Filter mFilter;
+    Report mReport;
+    std::vector<int16_t> mRefTaps;
+    BorderMode mRefBorder;
+    std::vector<uint8_t> mRef;
+    size_t mLastSlot;
+    int mDecoded;
+    int mFailedFrames;
+};
+
+} // namespace f2d
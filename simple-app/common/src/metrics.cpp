@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "metrics.hpp"
+#include <chrono>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <stdio.h>
+
+namespace f2d {
+
+Histogram::Histogram(const std::vector<uint64_t> &boundsNs)
+    : mBounds(boundsNs),
+      mBuckets(new std::atomic<uint64_t>[boundsNs.size() + 1]) {
+    for (size_t i = 0; i <= mBounds.size(); i++)
+        mBuckets[i].store(0, std::memory_order_relaxed);
+}
+
+void Histogram::observe(uint64_t ns) {
+    size_t i = 0;
+    while (i < mBounds.size() && ns > mBounds[i])
+        i++;
+    mBuckets[i].fetch_add(1, std::memory_order_relaxed);
+    mCount.fetch_add(1, std::memory_order_relaxed);
+    mSum.fetch_add(ns, std::memory_order_relaxed);
+}
+
+uint64_t Histogram::bucket(size_t i) const {
+    return mBuckets[i].load(std::memory_order_relaxed);
+}
+
+MetricsRegistry::Entry *MetricsRegistry::find(const std::string &name,
+                                              const std::string &labels,
+                                              Type type) {
+    Entry *found = nullptr;
+    for (auto &e : mEntries) {
+        if (e->name != name)
+            continue;
+        if (e->type != type)
+            throw std::logic_error("metric " + name +
+                                   " registered with another type");
+        if (e->labels == labels)
+            found = e.get();
+    }
+    return found;
+}
+
+Counter &MetricsRegistry::counter(const std::string &name,
+                                  const std::string &help,
+                                  const std::string &labels) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    Entry *e = find(name, labels, COUNTER);
+    if (e == nullptr) {
+        mEntries.emplace_back(new Entry{name, help, labels, COUNTER,
+                                        std::unique_ptr<Counter>(new Counter),
+                                        nullptr, nullptr});
+        e = mEntries.back().get();
+    }
+    return *e->counter;
+}
+
+Gauge &MetricsRegistry::gauge(const std::string &name, const std::string &help,
+                              const std::string &labels) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    Entry *e = find(name, labels, GAUGE);
+    if (e == nullptr) {
+        mEntries.emplace_back(new Entry{name, help, labels, GAUGE, nullptr,
+                                        std::unique_ptr<Gauge>(new Gauge),
+                                        nullptr});
+        e = mEntries.back().get();
+    }
+    return *e->gauge;
+}
+
+Histogram &MetricsRegistry::histogram(const std::string &name,
+                                      const std::string &help,
+                                      const std::vector<uint64_t> &boundsNs) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    Entry *e = find(name, "", HISTOGRAM);
+    if (e == nullptr) {
+        mEntries.emplace_back(new Entry{
+            name, help, "", HISTOGRAM, nullptr, nullptr,
+            std::unique_ptr<Histogram>(new Histogram(boundsNs))});
+        e = mEntries.back().get();
+    }
+    return *e->histogram;
+}
+
+static std::string series(const std::string &name, const std::string &labels) {
+    return labels.empty() ? name : name + "{" + labels + "}";
+}
+
+std::string MetricsRegistry::render() const {
+    static const char *typeNames[] = {"counter", "gauge", "histogram"};
+    std::lock_guard<std::mutex> lock(mMutex);
+    std::ostringstream os;
+    std::set<std::string> described;
+
+    os.precision(12);
+
+    // all series of a name follow its HELP and TYPE lines
+    for (const auto &first : mEntries) {
+        if (!described.insert(first->name).second)
+            continue;
+        os << "# HELP " << first->name << " " << first->help << "\n"
+           << "# TYPE " << first->name << " " << typeNames[first->type]
+           << "\n";
+        for (const auto &e : mEntries) {
+            if (e->name != first->name)
+                continue;
+            if (e->type == COUNTER) {
+                os << series(e->name, e->labels) << " " << e->counter->value()
+                   << "\n";
+            } else if (e->type == GAUGE) {
+                os << series(e->name, e->labels) << " " << e->gauge->value()
+                   << "\n";
+            } else {
+                const Histogram &h = *e->histogram;
+                uint64_t cumulative = 0;
+                for (size_t i = 0; i < h.bounds().size(); i++) {
+                    cumulative += h.bucket(i);
+                    os << e->name << "_bucket{le=\"" << h.bounds()[i] * 1e-9
+                       << "\"} " << cumulative << "\n";
+                }
+                cumulative += h.bucket(h.bounds().size());
+                os << e->name << "_bucket{le=\"+Inf\"} " << cumulative << "\n"
+                   << e->name << "_sum " << h.sumNs() * 1e-9 << "\n"
+                   << e->name << "_count " << h.count() << "\n";
+            }
+        }
+    }
+    return os.str();
+}
+
+MetricsRegistry &metrics() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+HostMetrics &hostMetrics() {
+    // 10us .. ~1.3s in powers of two
+    static std::vector<uint64_t> bounds = [] {
+        std::vector<uint64_t> b;
+        for (uint64_t ns = 10000; ns < 2000000000; ns *= 2)
+            b.push_back(ns);
+        return b;
+    }();
+    static HostMetrics m = {
+        metrics().counter("f2d_frames_total", "Frames processed"),
+        metrics().counter("f2d_device_write_bytes_total",
+                          "Bytes transferred to the device"),
+        metrics().counter("f2d_device_read_bytes_total",
+                          "Bytes transferred from the device"),
+        metrics().histogram("f2d_kernel_seconds",
+                            "Accelerator execution time per launch", bounds),
+        metrics().histogram("f2d_frame_seconds",
+                            "Host processing time per frame", bounds),
+        metrics().gauge("f2d_pipeline_queue_frames",
+                        "Frames queued between pipeline stages"),
+        metrics().gauge("f2d_pipeline_free_slots",
+                        "Frame slots waiting for the pipeline source"),
+        metrics().gauge("f2d_pipeline_slots_in_flight",
+                        "Frame slots taken by frames between source and "
+                        "last stage"),
+        metrics().gauge("f2d_worker_bands_in_flight",
+                        "Row bands queued or running on the workers"),
+        metrics().counter("f2d_validation_failed_frames_total",
+                          "Frames not matching the reference"),
+        metrics().counter("f2d_validation_mismatched_bytes_total",
+                          "Bytes differing from the reference"),
+        metrics().gauge("f2d_device_buffer_bytes",
+                        "Device memory allocated for frame buffers"),
+    };
+    return m;
+}
+
+MetricsFileExporter::MetricsFileExporter(const MetricsRegistry &registry,
+                                         const std::string &path,
+                                         int intervalMs)
+    : mRegistry(registry), mPath(path), mIntervalMs(intervalMs),
+      mStop(false), mThread(&MetricsFileExporter::loop, this) {}
+
+MetricsFileExporter::~MetricsFileExporter() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mWake.notify_all();
+    mThread.join();
+    write();
+}
+
+bool MetricsFileExporter::write() const {
+    std::string tmp = mPath + ".tmp";
+    {
+        std::ofstream out(tmp.c_str(), std::ofstream::trunc);
+        out << mRegistry.render();
+        if (!out)
+            return false;
+    }
+    return rename(tmp.c_str(), mPath.c_str()) == 0;
+}
+
+void MetricsFileExporter::loop() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (!mWake.wait_for(lock, std::chrono::milliseconds(mIntervalMs),
+                           [&] { return mStop; })) {
+        lock.unlock();
+        write();
+        lock.lock();
+    }
+}
+
+} // namespace f2d
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace f2d {
+
+/*
+ * Metric types updated from the frame path. Updates are single relaxed
+ * atomic operations, no locks are taken; readers only need an approximately
+ * consistent snapshot.
+ */
+class Counter {
+  public:
+    void add(uint64_t n = 1) { mValue.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const { return mValue.load(std::memory_order_relaxed); }
+
+  private:
+    std::atomic<uint64_t> mValue{0};
+};
+
+class Gauge {
+  public:
+    void set(int64_t v) { mValue.store(v, std::memory_order_relaxed); }
+    void add(int64_t n) { mValue.fetch_add(n, std::memory_order_relaxed); }
+    int64_t value() const { return mValue.load(std::memory_order_relaxed); }
+
+  private:
+    std::atomic<int64_t> mValue{0};
+};
+
+/* Duration histogram, observed in ns and exported in seconds */
+class Histogram {
+  public:
+    /* Bucket upper bounds in ns, ascending */
+    explicit Histogram(const std::vector<uint64_t> &boundsNs);
+
+    void observe(uint64_t ns);
+
+    const std::vector<uint64_t> &bounds() const { return mBounds; }
+    uint64_t bucket(size_t i) const; // non-cumulative, last one is +Inf
+    uint64_t count() const { return mCount.load(std::memory_order_relaxed); }
+    uint64_t sumNs() const { return mSum.load(std::memory_order_relaxed); }
+
+  private:
+    std::vector<uint64_t> mBounds;
+    std::unique_ptr<std::atomic<uint64_t>[]> mBuckets;
+    std::atomic<uint64_t> mCount{0};
+    std::atomic<uint64_t> mSum{0};
+};
+
+/*
+ * Owns all metrics and renders them in the Prometheus text exposition
+ * format. Registration takes a lock and is meant for start-up; the returned
+ * references stay valid for the life of the registry. Series sharing a
+ * name differ by their label string, e.g. "worker=\"cpu\"", and must be of
+ * the same type.
+ */
+class MetricsRegistry {
+  public:
+    Counter &counter(const std::string &name, const std::string &help,
+                     const std::string &labels = "");
+    Gauge &gauge(const std::string &name, const std::string &help,
+                 const std::string &labels = "");
+    Histogram &histogram(const std::string &name, const std::string &help,
+                         const std::vector<uint64_t> &boundsNs);
+
+    std::string render() const;
+
+  private:
+    enum Type { COUNTER, GAUGE, HISTOGRAM };
+    struct Entry {
+        std::string name;
+        std::string help;
+        std::string labels;
+        Type type;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+    };
+
+    /* Throws std::logic_error if name is registered with another type */
+    Entry *find(const std::string &name, const std::string &labels,
+                Type type);
+
+    mutable std::mutex mMutex;
+    std::vector<std::unique_ptr<Entry>> mEntries;
+};
+
+/* Process-wide registry used by the hosts */
+MetricsRegistry &metrics();
+
+/* The series every host reports, registered on first use */
+struct HostMetrics {
+    Counter &frames;
+    Counter &bytesToDevice;
+    Counter &bytesFromDevice;
+    Histogram &kernelTime;
+    Histogram &frameTime;
+    Gauge &pipelineQueue;
+    Gauge &freeSlots;
+    Gauge &slotsInFlight;
+    Gauge &workerBands;
+    Counter &failedFrames;
+    Counter &mismatchedBytes;
+    Gauge &deviceBufferBytes;
+};
+HostMetrics &hostMetrics();
+
+/*
+ * Rewrites a Prometheus text file every intervalMs from a background
+ * thread, e.g. for the node_exporter textfile collector. The file is
+ * replaced atomically through a rename and written a last time on
+ * destruction.
+ */
+class MetricsFileExporter {
+  public:
+    MetricsFileExporter(const MetricsRegistry &registry,
+                        const std::string &path, int intervalMs = 1000);
+    ~MetricsFileExporter();
+
+    bool write() const;
+
+  private:
+    void loop();
+
+    const MetricsRegistry &mRegistry;
+    std::string mPath;
+    int mIntervalMs;
+    bool mStop;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::thread mThread;
+};
+
+} // namespace f2d
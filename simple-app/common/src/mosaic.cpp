@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mosaic.hpp"
+#include <algorithm>
+#include <string.h>
+
+namespace f2d {
+
+MosaicPacker::MosaicPacker(int atlasWidth, int atlasHeight)
+    : mAtlasWidth(atlasWidth), mAtlasHeight(atlasHeight) {
+    reset();
+}
+
+void MosaicPacker::reset() {
+    mShelfY = 0;
+    mShelfHeight = 0;
+    mCursorX = 0;
+    mUsedRows = 0;
+    mCount = 0;
+}
+
+bool MosaicPacker::add(int width, int height, MosaicSlot *slot) {
+    if (width <= 0 || height <= 0 || (width & 1) || width > mAtlasWidth)
+        return false;
+
+    if (mCursorX + width > mAtlasWidth) {
+        // open a new shelf below the tallest image of the current one
+        mShelfY += mShelfHeight + MOSAIC_GUARD_ROWS;
+        mShelfHeight = 0;
+        mCursorX = 0;
+    }
+    if (mShelfY + height > mAtlasHeight)
+        return false;
+
+    *slot = {mCursorX, mShelfY, width, height};
+    mCursorX += width + MOSAIC_GUARD_COLS;
+    mShelfHeight = std::max(mShelfHeight, height);
+    mUsedRows = std::max(mUsedRows, mShelfY + height);
+    mCount++;
+    return true;
+}
+
+/* Halo sample (r, c) of an image: luma by the border mode, neutral chroma */
+static void haloSample(const uint8_t *img, const MosaicSlot &slot, int r,
+                       int c, BorderMode border, uint8_t *p) {
+    int sr = borderIndex(r, slot.height, border);
+    int sc = borderIndex(c, slot.width, border);
+    p[0] = (sr < 0 || sc < 0) ? 0 : img[((size_t)sr * slot.width + sc) * 2];
+    p[1] = 128;
+}
+
+void mosaicPack(const uint8_t *img, uint8_t *atlas, int atlasWidth,
+                int atlasHeight, const MosaicSlot &slot, BorderMode border) {
+    size_t stride = (size_t)atlasWidth * 2;
+    size_t rowBytes = (size_t)slot.width * 2;
+    int first = slot.x > 0 ? -1 : 0;
+    int last = slot.x + slot.width < atlasWidth ? slot.width : slot.width - 1;
+
+    auto sample = [&](int r, int c) {
+        return atlas + (slot.y + r) * stride + (slot.x + c) * 2;
+    };
+
+    if (slot.y > 0) {
+        for (int c = first; c <= last; c++)
+            haloSample(img, slot, -1, c, border, sample(-1, c));
+    }
+    for (int r = 0; r < slot.height; r++) {
+        if (first < 0)
+            haloSample(img, slot, r, -1, border, sample(r, -1));
+        memcpy(sample(r, 0), img + r * rowBytes, rowBytes);
+        if (last == slot.width)
+            haloSample(img, slot, r, slot.width, border, sample(r, last));
+    }
+    if (slot.y + slot.height < atlasHeight) {
+        for (int c = first; c <= last; c++)
+            haloSample(img, slot, slot.height, c, border,
+                       sample(slot.height, c));
+    }
+}
+
+void mosaicUnpack(const uint8_t *atlas, int atlasWidth,
+                  const MosaicSlot &slot, uint8_t *img) {
+    size_t stride = (size_t)atlasWidth * 2;
+    size_t rowBytes = (size_t)slot.width * 2;
+
+    for (int r = 0; r < slot.height; r++)
+        memcpy(img + r * rowBytes,
+               atlas + (slot.y + r) * stride + slot.x * 2, rowBytes);
+}
+
+} // namespace f2d
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "border.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace f2d {
+
+/*
+ * Guard between neighbours: one halo column of each, a whole YUYV
+ * macropixel together, and one halo row of each
+ */
+static constexpr int MOSAIC_GUARD_COLS = 2;
+static constexpr int MOSAIC_GUARD_ROWS = 2;
+
+/* Position of one image inside the atlas, in pixels */
+struct MosaicSlot {
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+/*
+ * Shelf packer placing small YUYV images into one frame-sized atlas so a
+ * batch of them is filtered by a single kernel launch. Neighbours are kept
+ * apart by guard columns and rows, in which mosaicPack() surrounds every
+ * image by a halo of its own border samples, so the 3x3 window of every
+ * image sees exactly what it would see at the edge of a frame of its own.
+ * Images at the atlas edge get the border of the filter itself, which must
+ * apply the same border mode.
+ */
+class MosaicPacker {
+  public:
+    MosaicPacker(int atlasWidth, int atlasHeight);
+
+    /* Reserve a slot for a width x height image, false if it does not fit */
+    bool add(int width, int height, MosaicSlot *slot);
+    void reset();
+
+    int count() const { return mCount; }
+    /* Atlas rows holding images, the launch height of the batch */
+    int usedRows() const { return mUsedRows; }
+
+  private:
+    int mAtlasWidth;
+    int mAtlasHeight;
+    int mShelfY;
+    int mShelfHeight;
+    int mCursorX;
+    int mUsedRows;
+    int mCount;
+};
+
+/* Copy a YUYV image into its slot and fill the halo ring around it */
+void mosaicPack(const uint8_t *img, uint8_t *atlas, int atlasWidth,
+                int atlasHeight, const MosaicSlot &slot,
+                BorderMode border = BorderMode::CONSTANT);
+
+/* Copy the filtered image back out of its slot */
+void mosaicUnpack(const uint8_t *atlas, int atlasWidth,
+                  const MosaicSlot &slot, uint8_t *img);
+
+} // namespace f2d
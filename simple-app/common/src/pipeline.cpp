@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pipeline.hpp"
+#include "metrics.hpp"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+namespace f2d {
+
+Pipeline::Pipeline(size_t slots, const PlacementPolicy *placement)
+    : mSlots(std::max<size_t>(slots, 1)), mPlacement(placement),
+      mWallSec(0) {
+    mSteps.push_back(Step{"source", ThreadRole::DECODE, nullptr, 0, 0});
+}
+
+void Pipeline::setSource(const std::string &name, ThreadRole role,
+                         Source source) {
+    mSteps[0].name = name;
+    mSteps[0].role = role;
+    mSource = source;
+}
+
+void Pipeline::addStage(const std::string &name, ThreadRole role,
+                        Stage stage) {
+    mSteps.push_back(Step{name, role, stage, 0, 0});
+}
+
+void Pipeline::runStep(size_t idx, BoundedQueue<size_t> &in,
+                       BoundedQueue<size_t> &out, bool closeOut) {
+    Step &step = mSteps[idx];
+    HostMetrics &stats = hostMetrics();
+    size_t slot;
+
+    if (mPlacement)
+        mPlacement->pin(step.role);
+    // frames waiting between stages count towards the queue, the slot
+    // pool is counted apart: a slot is in flight from the source taking it
+    // until the last stage hands it back
+    while (in.pop(&slot)) {
+        if (idx > 0) {
+            stats.pipelineQueue.add(-1);
+        } else {
+            stats.freeSlots.add(-1);
+            stats.slotsInFlight.add(1);
+        }
+        auto t0 = std::chrono::steady_clock::now();
+        bool more = true;
+        if (idx == 0)
+            more = mSource(slot);
+        else
+            step.stage(slot);
+        std::chrono::duration<double> dt =
+            std::chrono::steady_clock::now() - t0;
+        step.busySec += dt.count();
+        if (!more) {
+            stats.slotsInFlight.add(-1);
+            stats.freeSlots.add(1);
+            break;
+        }
+        step.frames++;
+        if (closeOut) {
+            stats.pipelineQueue.add(1);
+        } else {
+            stats.slotsInFlight.add(-1);
+            stats.freeSlots.add(1);
+        }
+        out.push(slot);
+    }
+    if (closeOut)
+        out.close();
+}
+
+uint64_t Pipeline::run() {
+    size_t n = mSteps.size();
+    // queues[k] feeds step k, queues[0] holds the free slots
+    std::vector<std::unique_ptr<BoundedQueue<size_t>>> queues;
+    std::vector<std::thread> threads;
+
+    for (size_t k = 0; k < n; k++)
+        queues.emplace_back(new BoundedQueue<size_t>(mSlots));
+    for (size_t slot = 0; slot < mSlots; slot++)
+        queues[0]->push(slot);
+    hostMetrics().freeSlots.add(mSlots);
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t k = 0; k < n; k++) {
+        // the last step recycles slots into the free queue, which the
+        // source stops reading from by itself
+        threads.emplace_back(&Pipeline::runStep, this, k, std::ref(*queues[k]),
+                             std::ref(*queues[(k + 1) % n]), k + 1 < n);
+    }
+    for (std::thread &t : threads)
+        t.join();
+    hostMetrics().freeSlots.add(-(int64_t)mSlots);
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - t0;
+    mWallSec = wall.count();
+    return mSteps[0].frames;
+}
+
+void Pipeline::printStats(std::ostream &os) const {
+    for (const Step &s : mSteps)
+        os << "Stage " << s.name << ": " << s.frames << " frames, busy "
+           << s.busySec * 1000 << "ms ("
+           << (mWallSec > 0 ? 100 * s.busySec / mWallSec : 0.0) << "%)"
+           << std::endl;
+}
+
+} // namespace f2d
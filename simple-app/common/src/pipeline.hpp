@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "placement.hpp"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace f2d {
+
+/* FIFO of at most capacity items, push() blocks while it is full */
+template <typename T> class BoundedQueue {
+  public:
+    explicit BoundedQueue(size_t capacity)
+        : mCapacity(capacity), mClosed(false) {}
+
+    void push(const T &item) {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mNotFull.wait(lock, [&] { return mItems.size() < mCapacity; });
+        mItems.push_back(item);
+        mNotEmpty.notify_one();
+    }
+
+    /* Blocks while empty, false once closed and drained */
+    bool pop(T *item) {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mNotEmpty.wait(lock, [&] { return mClosed || !mItems.empty(); });
+        if (mItems.empty())
+            return false;
+        *item = mItems.front();
+        mItems.pop_front();
+        mNotFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mClosed = true;
+        mNotEmpty.notify_all();
+    }
+
+  private:
+    size_t mCapacity;
+    bool mClosed;
+    std::deque<T> mItems;
+    std::mutex mMutex;
+    std::condition_variable mNotEmpty;
+    std::condition_variable mNotFull;
+};
+
+/*
+ * Runs a chain of stages over frames, every stage on a thread of its own,
+ * so decoding, conversion, device work and validation of consecutive frames
+ * overlap. The frames live in a fixed set of slots owned by the caller and
+ * only slot indices travel between the stages, through bounded queues: the
+ * source fills a free slot, every stage processes it in turn and the last
+ * one hands it back. The number of slots bounds the frames in flight, with
+ * one slot the stages run strictly one after another. Frames keep their
+ * order through all stages.
+ */
+class Pipeline {
+  public:
+    /* Produce the next frame in slot, false at the end of the stream */
+    using Source = std::function<bool(size_t slot)>;
+    using Stage = std::function<void(size_t slot)>;
+
+    /* placement may be null, otherwise every thread is pinned by role */
+    Pipeline(size_t slots, const PlacementPolicy *placement = nullptr);
+
+    void setSource(const std::string &name, ThreadRole role, Source source);
+    void addStage(const std::string &name, ThreadRole role, Stage stage);
+
+    /* Run until the source ends and every frame passed all stages */
+    uint64_t run();
+
+    /* Frames and busy time per stage, the busiest one bounds throughput */
+    void printStats(std::ostream &os) const;
+
+  private:
+    struct Step {
+        std::string name;
+        ThreadRole role;
+        Stage stage;
+        uint64_t frames;
+        double busySec;
+    };
+
+    void runStep(size_t idx, BoundedQueue<size_t> &in,
+                 BoundedQueue<size_t> &out, bool closeOut);
+
+    size_t mSlots;
+    const PlacementPolicy *mPlacement;
+    Source mSource;
+    std::vector<Step> mSteps; // the source first
+    double mWallSec;
+};
+
+} // namespace f2d
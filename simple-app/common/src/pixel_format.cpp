@@ -0,0 +1,393 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pixel_format.hpp"
+#include <algorithm>
+#include <string.h>
+#include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace f2d {
+
+static const char *formatNames[] = {"BGR", "YUYV", "NV12", "NV16", "GRAY8"};
+
+const char *formatName(PixelFormat fmt) { return formatNames[(int)fmt]; }
+
+bool parseFormat(const std::string &name, PixelFormat *fmt) {
+    for (int i = 0; i < 5; i++) {
+        if (name == formatNames[i]) {
+            *fmt = (PixelFormat)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t formatFourcc(PixelFormat fmt) {
+    switch (fmt) {
+    case PixelFormat::BGR:
+        return 0x33524742; // BGR3
+    case PixelFormat::YUYV:
+        return 0x56595559; // YUYV
+    case PixelFormat::NV12:
+        return 0x3231564E; // NV12
+    case PixelFormat::NV16:
+        return 0x3631564E; // NV16
+    case PixelFormat::GRAY8:
+        return 0x30303859; // Y800
+    }
+    return 0;
+}
+
+size_t frameBytes(PixelFormat fmt, int width, int height) {
+    size_t pixels = (size_t)width * height;
+    switch (fmt) {
+    case PixelFormat::BGR:
+        return pixels * 3;
+    case PixelFormat::YUYV:
+    case PixelFormat::NV16:
+        return pixels * 2;
+    case PixelFormat::NV12:
+        return pixels * 3 / 2;
+    case PixelFormat::GRAY8:
+        return pixels;
+    }
+    return 0;
+}
+
+static inline uint8_t clamp8(int v) {
+    return (uint8_t)std::min(std::max(v, 0), 255);
+}
+
+/* YUYV -> Y plane + interleaved 4:2:2 UV plane */
+static void splitYuyv(const uint8_t *src, uint8_t *y, uint8_t *uv,
+                      size_t pixels) {
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128i lo = _mm_set1_epi16(0x00FF);
+    for (; i + 16 <= pixels; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(src + 2 * i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(src + 2 * i + 16));
+        _mm_storeu_si128((__m128i *)(y + i),
+                         _mm_packus_epi16(_mm_and_si128(a, lo),
+                                          _mm_and_si128(b, lo)));
+        _mm_storeu_si128((__m128i *)(uv + i),
+                         _mm_packus_epi16(_mm_srli_epi16(a, 8),
+                                          _mm_srli_epi16(b, 8)));
+    }
+#endif
+    for (; i < pixels; i++) {
+        y[i] = src[2 * i];
+        uv[i] = src[2 * i + 1];
+    }
+}
+
+/* Y plane + interleaved 4:2:2 UV plane -> YUYV */
+static void mergeYuyv(const uint8_t *y, const uint8_t *uv, uint8_t *dst,
+                      size_t pixels) {
+    size_t i = 0;
+#ifdef __SSE2__
+    for (; i + 16 <= pixels; i += 16) {
+        __m128i vy = _mm_loadu_si128((const __m128i *)(y + i));
+        __m128i vc = _mm_loadu_si128((const __m128i *)(uv + i));
+        _mm_storeu_si128((__m128i *)(dst + 2 * i), _mm_unpacklo_epi8(vy, vc));
+        _mm_storeu_si128((__m128i *)(dst + 2 * i + 16),
+                         _mm_unpackhi_epi8(vy, vc));
+    }
+#endif
+    for (; i < pixels; i++) {
+        dst[2 * i] = y[i];
+        dst[2 * i + 1] = uv[i];
+    }
+}
+
+/* 4:2:2 -> 4:2:0 chroma, rounded average of each pair of rows */
+static void downsampleUv(const uint8_t *uv422, uint8_t *uv420, int width,
+                         int height) {
+    for (int r = 0; r < height / 2; r++) {
+        const uint8_t *a = uv422 + (size_t)2 * r * width;
+        const uint8_t *b = a + width;
+        uint8_t *out = uv420 + (size_t)r * width;
+        int x = 0;
+#ifdef __SSE2__
+        for (; x + 16 <= width; x += 16)
+            _mm_storeu_si128(
+                (__m128i *)(out + x),
+                _mm_avg_epu8(_mm_loadu_si128((const __m128i *)(a + x)),
+                             _mm_loadu_si128((const __m128i *)(b + x))));
+#endif
+        for (; x < width; x++)
+            out[x] = (uint8_t)((a[x] + b[x] + 1) >> 1);
+    }
+}
+
+/* 4:2:0 -> 4:2:2 chroma, each row used twice */
+static void upsampleUv(const uint8_t *uv420, uint8_t *uv422, int width,
+                       int height) {
+    for (int r = 0; r < height; r++)
+        memcpy(uv422 + (size_t)r * width, uv420 + (size_t)(r / 2) * width,
+               width);
+}
+
+#ifdef __SSE2__
+/* 16 BGR pixels -> planes of 16 B, G and R samples */
+static inline void loadBgr16(const uint8_t *p, __m128i &b, __m128i &g,
+                             __m128i &r) {
+    __m128i t0 = _mm_loadu_si128((const __m128i *)p);
+    __m128i t1 = _mm_loadu_si128((const __m128i *)(p + 16));
+    __m128i t2 = _mm_loadu_si128((const __m128i *)(p + 32));
+
+    // each round interleaves the halves of the vectors, four rounds leave
+    // every channel in its own vector
+    for (int round = 0; round < 4; round++) {
+        __m128i u0 = _mm_unpacklo_epi8(t0, _mm_unpackhi_epi64(t1, t1));
+        __m128i u1 = _mm_unpacklo_epi8(_mm_unpackhi_epi64(t0, t0), t2);
+        __m128i u2 = _mm_unpacklo_epi8(t1, _mm_unpackhi_epi64(t2, t2));
+        t0 = u0;
+        t1 = u1;
+        t2 = u2;
+    }
+    b = t0;
+    g = t1;
+    r = t2;
+}
+
+/* Planes of 16 B, G and R samples -> 16 BGR pixels */
+static inline void storeBgr16(uint8_t *p, __m128i b, __m128i g, __m128i r) {
+    const __m128i even = _mm_set1_epi16(0x00FF);
+
+    // inverse of the rounds of loadBgr16, the even and odd bytes of each
+    // vector go back to the halves they came from
+    for (int round = 0; round < 4; round++) {
+        __m128i t0 = _mm_packus_epi16(_mm_and_si128(b, even),
+                                      _mm_and_si128(g, even));
+        __m128i t1 = _mm_packus_epi16(_mm_and_si128(r, even),
+                                      _mm_srli_epi16(b, 8));
+        __m128i t2 = _mm_packus_epi16(_mm_srli_epi16(g, 8),
+                                      _mm_srli_epi16(r, 8));
+        b = t0;
+        g = t1;
+        r = t2;
+    }
+    _mm_storeu_si128((__m128i *)p, b);
+    _mm_storeu_si128((__m128i *)(p + 16), g);
+    _mm_storeu_si128((__m128i *)(p + 32), r);
+}
+
+/* a * ca + b * cb of 8 int16 pairs, in two vectors of 4 int32 */
+static inline void madd8(__m128i a, __m128i b, __m128i coeffs, __m128i &lo,
+                         __m128i &hi) {
+    lo = _mm_madd_epi16(_mm_unpacklo_epi16(a, b), coeffs);
+    hi = _mm_madd_epi16(_mm_unpackhi_epi16(a, b), coeffs);
+}
+
+/* (x + half) >> 14 of 8 int32, saturated to int16 */
+static inline __m128i roundQ14(__m128i lo, __m128i hi) {
+    const __m128i half = _mm_set1_epi32(1 << 13);
+    return _mm_packs_epi32(_mm_srai_epi32(_mm_add_epi32(lo, half), 14),
+                           _mm_srai_epi32(_mm_add_epi32(hi, half), 14));
+}
+
+static inline __m128i coeffPair(int16_t ca, int16_t cb) {
+    return _mm_setr_epi16(ca, cb, ca, cb, ca, cb, ca, cb);
+}
+
+/*
+ * Y of 8 pixels and the averaged U, V of their 4 pairs, as int16
+ * Y0..Y7 and U0 V0 .. U3 V3
+ */
+static inline void yuv422Of8(__m128i b, __m128i g, __m128i r, __m128i &y,
+                             __m128i &uv) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i bias = _mm_set1_epi16(128);
+    __m128i lo, hi, rLo, rHi;
+
+    madd8(b, g, coeffPair(1868, 9617), lo, hi);
+    madd8(r, zero, coeffPair(4899, 0), rLo, rHi);
+    y = roundQ14(_mm_add_epi32(lo, rLo), _mm_add_epi32(hi, rHi));
+
+    // the bias of 128 << 14 is a whole multiple, added after the shift
+    madd8(_mm_sub_epi16(b, y), zero, coeffPair(8061, 0), lo, hi);
+    __m128i u = _mm_add_epi16(roundQ14(lo, hi), bias);
+    madd8(_mm_sub_epi16(r, y), zero, coeffPair(14369, 0), lo, hi);
+    __m128i v = _mm_add_epi16(roundQ14(lo, hi), bias);
+
+    // rounded average of each pixel pair
+    const __m128i round = _mm_set1_epi32(1);
+    u = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(u, one), round), 1);
+    v = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(v, one), round), 1);
+    uv = _mm_packs_epi32(_mm_unpacklo_epi32(u, v), _mm_unpackhi_epi32(u, v));
+}
+#endif
+
+/*
+ * BT.601 in Q14 fixed point, the same weights cv::COLOR_BGR2YUV uses:
+ * Y = .299R + .587G + .114B, U = .492(B - Y), V = .877(R - Y)
+ */
+static void bgrToYuv422(const uint8_t *bgr, uint8_t *y, uint8_t *uv,
+                        int width, int height) {
+    const int half = 1 << 13;
+    const int bias = 128 << 14;
+    size_t pixels = (size_t)width * height;
+    size_t i = 0;
+
+#ifdef __SSE2__
+    // madd keeps the products in 32 bit, results match the scalar code
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= pixels; i += 16) {
+        __m128i b, g, r, y0, y1, uv0, uv1;
+        loadBgr16(bgr + 3 * i, b, g, r);
+        yuv422Of8(_mm_unpacklo_epi8(b, zero), _mm_unpacklo_epi8(g, zero),
+                  _mm_unpacklo_epi8(r, zero), y0, uv0);
+        yuv422Of8(_mm_unpackhi_epi8(b, zero), _mm_unpackhi_epi8(g, zero),
+                  _mm_unpackhi_epi8(r, zero), y1, uv1);
+        _mm_storeu_si128((__m128i *)(y + i), _mm_packus_epi16(y0, y1));
+        _mm_storeu_si128((__m128i *)(uv + i), _mm_packus_epi16(uv0, uv1));
+    }
+#endif
+    for (; i < pixels; i += 2) {
+        const uint8_t *p = bgr + 3 * i;
+        int y0 = (1868 * p[0] + 9617 * p[1] + 4899 * p[2] + half) >> 14;
+        int y1 = (1868 * p[3] + 9617 * p[4] + 4899 * p[5] + half) >> 14;
+        int u0 = ((p[0] - y0) * 8061 + bias + half) >> 14;
+        int u1 = ((p[3] - y1) * 8061 + bias + half) >> 14;
+        int v0 = ((p[2] - y0) * 14369 + bias + half) >> 14;
+        int v1 = ((p[5] - y1) * 14369 + bias + half) >> 14;
+        y[i] = clamp8(y0);
+        y[i + 1] = clamp8(y1);
+        uv[i] = clamp8((u0 + u1 + 1) >> 1);
+        uv[i + 1] = clamp8((v0 + v1 + 1) >> 1);
+    }
+}
+
+static void yuv422ToBgr(const uint8_t *y, const uint8_t *uv, uint8_t *bgr,
+                        int width, int height) {
+    const int half = 1 << 13;
+    size_t pixels = (size_t)width * height;
+    size_t i = 0;
+
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i even = _mm_set1_epi16(0x00FF);
+    const __m128i bias = _mm_set1_epi16(128);
+    for (; i + 16 <= pixels; i += 16) {
+        __m128i vy = _mm_loadu_si128((const __m128i *)(y + i));
+        __m128i vc = _mm_loadu_si128((const __m128i *)(uv + i));
+        __m128i u = _mm_sub_epi16(_mm_and_si128(vc, even), bias);
+        __m128i v = _mm_sub_epi16(_mm_srli_epi16(vc, 8), bias);
+        __m128i lo, hi;
+
+        // deltas of the 8 pixel pairs; 33292 exceeds int16, so u is
+        // weighted twice by 16646 instead
+        madd8(v, zero, coeffPair(18678, 0), lo, hi);
+        __m128i dr = roundQ14(lo, hi);
+        madd8(u, v, coeffPair(-6472, -9519), lo, hi);
+        __m128i dg = roundQ14(lo, hi);
+        madd8(u, u, coeffPair(16646, 16646), lo, hi);
+        __m128i db = roundQ14(lo, hi);
+
+        // both pixels of a pair share the deltas
+        __m128i y0 = _mm_unpacklo_epi8(vy, zero);
+        __m128i y1 = _mm_unpackhi_epi8(vy, zero);
+        storeBgr16(
+            bgr + 3 * i,
+            _mm_packus_epi16(_mm_add_epi16(y0, _mm_unpacklo_epi16(db, db)),
+                             _mm_add_epi16(y1, _mm_unpackhi_epi16(db, db))),
+            _mm_packus_epi16(_mm_add_epi16(y0, _mm_unpacklo_epi16(dg, dg)),
+                             _mm_add_epi16(y1, _mm_unpackhi_epi16(dg, dg))),
+            _mm_packus_epi16(_mm_add_epi16(y0, _mm_unpacklo_epi16(dr, dr)),
+                             _mm_add_epi16(y1, _mm_unpackhi_epi16(dr, dr))));
+    }
+#endif
+    for (; i < pixels; i += 2) {
+        int u = uv[i] - 128;
+        int v = uv[i + 1] - 128;
+        int dr = (18678 * v + half) >> 14;
+        int dg = (-6472 * u - 9519 * v + half) >> 14;
+        int db = (33292 * u + half) >> 14;
+        for (int k = 0; k < 2; k++) {
+            uint8_t *p = bgr + 3 * (i + k);
+            p[0] = clamp8(y[i + k] + db);
+            p[1] = clamp8(y[i + k] + dg);
+            p[2] = clamp8(y[i + k] + dr);
+        }
+    }
+}
+
+void convertFrame(const uint8_t *src, PixelFormat from, uint8_t *dst,
+                  PixelFormat to, int width, int height) {
+    size_t pixels = (size_t)width * height;
+    std::vector<uint8_t> tmp;
+    const uint8_t *y = src;
+    const uint8_t *uv = src + pixels;
+
+    if (from == to) {
+        memcpy(dst, src, frameBytes(from, width, height));
+        return;
+    }
+
+    // read into a Y plane and a 4:2:2 UV plane
+    switch (from) {
+    case PixelFormat::BGR:
+        tmp.resize(2 * pixels);
+        bgrToYuv422(src, tmp.data(), tmp.data() + pixels, width, height);
+        y = tmp.data();
+        uv = tmp.data() + pixels;
+        break;
+    case PixelFormat::YUYV:
+        tmp.resize(2 * pixels);
+        splitYuyv(src, tmp.data(), tmp.data() + pixels, pixels);
+        y = tmp.data();
+        uv = tmp.data() + pixels;
+        break;
+    case PixelFormat::NV12:
+        tmp.resize(pixels);
+        upsampleUv(src + pixels, tmp.data(), width, height);
+        uv = tmp.data();
+        break;
+    case PixelFormat::NV16:
+        break;
+    case PixelFormat::GRAY8:
+        tmp.assign(pixels, 128);
+        uv = tmp.data();
+        break;
+    }
+
+    switch (to) {
+    case PixelFormat::BGR:
+        yuv422ToBgr(y, uv, dst, width, height);
+        break;
+    case PixelFormat::YUYV:
+        mergeYuyv(y, uv, dst, pixels);
+        break;
+    case PixelFormat::NV12:
+        memcpy(dst, y, pixels);
+        downsampleUv(uv, dst + pixels, width, height);
+        break;
+    case PixelFormat::NV16:
+        memcpy(dst, y, pixels);
+        memcpy(dst + pixels, uv, pixels);
+        break;
+    case PixelFormat::GRAY8:
+        memcpy(dst, y, pixels);
+        break;
+    }
+}
+
+} // namespace f2d
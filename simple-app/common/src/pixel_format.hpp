@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace f2d {
+
+/*
+ * Frame layouts handled by the hosts, all 8 bit per sample:
+ *   BGR   - packed B, G, R (OpenCV's default)
+ *   YUYV  - packed 4:2:2, Y0 U Y1 V
+ *   NV12  - Y plane followed by an interleaved UV plane at half height
+ *   NV16  - Y plane followed by an interleaved UV plane at full height
+ *   GRAY8 - Y plane only
+ * The YUV formats use BT.601 full range like cv::COLOR_BGR2YUV. Widths must
+ * be even, NV12 heights too.
+ */
+enum class PixelFormat { BGR, YUYV, NV12, NV16, GRAY8 };
+
+const char *formatName(PixelFormat fmt);
+bool parseFormat(const std::string &name, PixelFormat *fmt);
+
+/* FOURCC code of the format as passed to the PL kernel */
+uint32_t formatFourcc(PixelFormat fmt);
+
+size_t frameBytes(PixelFormat fmt, int width, int height);
+
+/* True for the formats whose luma samples form a contiguous plane */
+inline bool isPlanarLuma(PixelFormat fmt) {
+    return fmt == PixelFormat::NV12 || fmt == PixelFormat::NV16 ||
+           fmt == PixelFormat::GRAY8;
+}
+
+/* Bytes between horizontally adjacent luma samples of YUYV and planar luma */
+inline int lumaStep(PixelFormat fmt) {
+    return fmt == PixelFormat::YUYV ? 2 : 1;
+}
+
+/*
+ * Convert a frame between any two formats. Conversions between the YUV
+ * layouts only repack samples, chroma is averaged when subsampled and
+ * replicated when upsampled; GRAY8 reads as neutral chroma.
+ */
+void convertFrame(const uint8_t *src, PixelFormat from, uint8_t *dst,
+                  PixelFormat to, int width, int height);
+
+} // namespace f2d
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "placement.hpp"
+#include <chrono>
+#include <fstream>
+#include <new>
+#include <sched.h>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace f2d {
+
+// from <numaif.h>, called through syscall() to avoid a libnuma dependency
+static constexpr int MPOL_PREFERRED_MODE = 1;
+
+static std::string readLine(const std::string &path) {
+    std::ifstream in(path.c_str());
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+bool parseCpuList(const std::string &list, std::vector<int> *cpus) {
+    std::stringstream ss(list);
+    std::string item;
+
+    cpus->clear();
+    if (!list.empty() && list.back() == ',')
+        return false;
+    while (std::getline(ss, item, ',')) {
+        char *end;
+        long first = strtol(item.c_str(), &end, 10);
+        long last = first;
+        if (end == item.c_str() || first < 0)
+            return false;
+        if (*end == '-') {
+            const char *upper = end + 1;
+            last = strtol(upper, &end, 10);
+            if (end == upper)
+                return false;
+        }
+        if (*end != '\0' || last < first)
+            return false;
+        for (long c = first; c <= last; c++)
+            cpus->push_back((int)c);
+    }
+    return !cpus->empty();
+}
+
+std::vector<int> numaNodes() {
+    std::vector<int> nodes;
+    if (!parseCpuList(readLine("/sys/devices/system/node/has_memory"), &nodes))
+        nodes.assign(1, 0);
+    return nodes;
+}
+
+std::vector<int> nodeCpus(int node) {
+    std::vector<int> cpus;
+    if (node >= 0)
+        parseCpuList(readLine("/sys/devices/system/node/node" +
+                              std::to_string(node) + "/cpulist"),
+                     &cpus);
+    return cpus;
+}
+
+int pciNumaNode(const std::string &bdf) {
+    std::string path = bdf.find(':') == bdf.rfind(':') ? "0000:" + bdf : bdf;
+    std::string node = readLine("/sys/bus/pci/devices/" + path + "/numa_node");
+    return node.empty() ? -1 : atoi(node.c_str());
+}
+
+bool pinThread(pthread_t thread, const std::vector<int> &cpus) {
+    cpu_set_t set;
+
+    if (cpus.empty())
+        return true;
+    CPU_ZERO(&set);
+    for (int c : cpus)
+        CPU_SET(c, &set);
+    return pthread_setaffinity_np(thread, sizeof(set), &set) == 0;
+}
+
+NodeBuffer::NodeBuffer(size_t bytes, int node)
+    : mData(nullptr), mBytes(bytes), mNode(node), mBound(false) {
+    void *p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+        throw std::bad_alloc();
+    mData = (uint8_t *)p;
+
+    if (node >= 0) {
+        const size_t bits = 8 * sizeof(unsigned long);
+        std::vector<unsigned long> mask(node / bits + 1, 0);
+        mask[node / bits] = 1UL << (node % bits);
+        mBound = syscall(SYS_mbind, p, bytes, MPOL_PREFERRED_MODE,
+                         mask.data(), mask.size() * bits + 1, 0) == 0;
+    }
+    // first touch, fault every page in now and on the bound node
+    memset(mData, 0, bytes);
+}
+
+NodeBuffer::~NodeBuffer() { munmap(mData, mBytes); }
+
+static const char *roleNames[] = {"decode", "convert", "submit", "writer"};
+
+const char *roleName(ThreadRole role) { return roleNames[(int)role]; }
+
+PlacementPolicy::PlacementPolicy(int node) { setNode(node); }
+
+void PlacementPolicy::setNode(int node) {
+    mNode = node;
+    mNodeCpus = nodeCpus(node);
+}
+
+bool PlacementPolicy::parse(const std::string &spec) {
+    std::stringstream ss(spec);
+    std::string item;
+
+    if (!spec.empty() && spec.back() == ':')
+        return false;
+    while (std::getline(ss, item, ':')) {
+        size_t eq = item.find('=');
+        int role = 0;
+        while (role < THREAD_ROLES && item.compare(0, eq, roleNames[role]))
+            role++;
+        if (eq == std::string::npos || role == THREAD_ROLES ||
+            !parseCpuList(item.substr(eq + 1), &mRoleCpus[role]))
+            return false;
+    }
+    return true;
+}
+
+const std::vector<int> &PlacementPolicy::cpus(ThreadRole role) const {
+    const std::vector<int> &own = mRoleCpus[(int)role];
+    return own.empty() ? mNodeCpus : own;
+}
+
+void PlacementPolicy::print(std::ostream &os) const {
+    os << "Placement: node " << mNode;
+    for (int role = 0; role < THREAD_ROLES; role++) {
+        const std::vector<int> &set = cpus((ThreadRole)role);
+        os << ", " << roleNames[role] << " ";
+        if (set.empty())
+            os << "unpinned";
+        for (size_t i = 0; i < set.size(); i++)
+            os << (i ? "," : "") << set[i];
+    }
+    os << std::endl;
+}
+
+void runPlacementBench(const PlacementPolicy &placement,
+                       FrameTransfer *device, size_t bytes, std::ostream &os) {
+    const int repeat = 20;
+    NodeBuffer home(bytes, placement.node());
+
+    placement.pin(ThreadRole::SUBMIT);
+    for (int node : numaNodes()) {
+        NodeBuffer buf(bytes, node);
+        std::chrono::duration<double> to, from;
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (int n = 0; n < repeat; n++) {
+            if (device)
+                device->upload(buf.data(), bytes);
+            else
+                memcpy(home.data(), buf.data(), bytes);
+        }
+        to = std::chrono::steady_clock::now() - t0;
+
+        t0 = std::chrono::steady_clock::now();
+        for (int n = 0; n < repeat; n++) {
+            if (device)
+                device->download(buf.data(), bytes);
+            else
+                memcpy(buf.data(), home.data(), bytes);
+        }
+        from = std::chrono::steady_clock::now() - t0;
+
+        os << "Node " << node << (node == placement.node() ? " (local)" : "")
+           << ": " << (device ? "to device " : "from node ")
+           << bytes * repeat / to.count() / 1e9 << " GB/s, "
+           << (device ? "from device " : "to node ")
+           << bytes * repeat / from.count() / 1e9 << " GB/s"
+           << (buf.bound() ? "" : " (unbound)") << std::endl;
+    }
+}
+
+} // namespace f2d
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <ostream>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace f2d {
+
+/* Parse a kernel style CPU or node list, e.g. "0-3,8,10-11" */
+bool parseCpuList(const std::string &list, std::vector<int> *cpus);
+
+/* NUMA nodes with memory, {0} on kernels without NUMA support */
+std::vector<int> numaNodes();
+
+/* CPUs of a NUMA node, empty if the node does not exist */
+std::vector<int> nodeCpus(int node);
+
+/*
+ * NUMA node of a PCIe function from sysfs, bdf as returned by
+ * CL_DEVICE_PCIE_BDF ("0000:65:00.0" or without the domain). Returns -1
+ * if unknown, which is also what single socket machines report.
+ */
+int pciNumaNode(const std::string &bdf);
+
+/* Restrict a thread to the given CPUs, an empty set leaves it unpinned */
+bool pinThread(pthread_t thread, const std::vector<int> &cpus);
+
+inline bool pinThread(std::thread &thread, const std::vector<int> &cpus) {
+    return pinThread(thread.native_handle(), cpus);
+}
+
+inline bool pinCurrentThread(const std::vector<int> &cpus) {
+    return pinThread(pthread_self(), cpus);
+}
+
+/*
+ * Page aligned buffer whose pages are placed on one NUMA node. The range is
+ * bound with mbind(MPOL_PREFERRED), so allocation falls back to other nodes
+ * when the node runs out of memory, and then touched once so every page is
+ * faulted in up front rather than on the frame path. With node < 0 it is a
+ * plain buffer placed by the first touch of the allocating thread.
+ */
+class NodeBuffer {
+  public:
+    NodeBuffer(size_t bytes, int node);
+    ~NodeBuffer();
+    NodeBuffer(const NodeBuffer &) = delete;
+    NodeBuffer &operator=(const NodeBuffer &) = delete;
+
+    uint8_t *data() const { return mData; }
+    size_t size() const { return mBytes; }
+    int node() const { return mNode; }
+    bool bound() const { return mBound; } // mbind() succeeded
+
+  private:
+    uint8_t *mData;
+    size_t mBytes;
+    int mNode;
+    bool mBound;
+};
+
+/* Host threads with a core set of their own */
+enum class ThreadRole { DECODE, CONVERT, SUBMIT, WRITER };
+static constexpr int THREAD_ROLES = 4;
+
+const char *roleName(ThreadRole role);
+
+/*
+ * Where frame buffers and host threads go. The node is the one the card is
+ * attached to, or a configured one on machines without a card. Each thread
+ * role gets the cores given for it, roles without cores of their own run on
+ * the cores of the node, and with no node known threads stay unpinned.
+ */
+class PlacementPolicy {
+  public:
+    explicit PlacementPolicy(int node = -1);
+
+    /* Core sets as "decode=0-3:convert=4-7,12:submit=8:writer=9" */
+    bool parse(const std::string &spec);
+
+    void setNode(int node);
+    int node() const { return mNode; }
+
+    const std::vector<int> &cpus(ThreadRole role) const;
+    bool pin(ThreadRole role) const { return pinCurrentThread(cpus(role)); }
+    bool pin(ThreadRole role, std::thread &thread) const {
+        return pinThread(thread, cpus(role));
+    }
+
+    void print(std::ostream &os) const;
+
+  private:
+    int mNode;
+    std::vector<int> mNodeCpus;
+    std::vector<int> mRoleCpus[THREAD_ROLES];
+};
+
+/* Plain frame transfers to and from a device */
+class FrameTransfer {
+  public:
+    virtual ~FrameTransfer() {}
+    virtual void upload(const uint8_t *src, size_t bytes) = 0;
+    virtual void download(uint8_t *dst, size_t bytes) = 0;
+};
+
+/*
+ * Move frames of bytes between buffers placed on every NUMA node and the
+ * device, or without a device a buffer on the placement node, from a
+ * thread pinned to the submit cores, and print the bandwidth of each node.
+ */
+void runPlacementBench(const PlacementPolicy &placement,
+                       FrameTransfer *device, size_t bytes, std::ostream &os);
+
+} // namespace f2d
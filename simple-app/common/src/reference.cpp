@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "reference.hpp"
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <string.h>
+
+namespace f2d {
+
+static const int cvBorders[] = {cv::BORDER_CONSTANT, cv::BORDER_REPLICATE,
+                                cv::BORDER_REFLECT_101};
+
+void referenceFilter(const uint8_t *src, uint8_t *dst, int width, int height,
+                     PixelFormat fmt, const int16_t *taps, int stages,
+                     BorderMode border) {
+    int step = lumaStep(fmt);
+    cv::Mat luma(height, width, CV_8UC1);
+    cv::Mat temp;
+
+    for (size_t i = 0; i < luma.total(); i++)
+        luma.data[i] = src[i * step];
+    for (int k = 0; k < stages; k++) {
+        float coeff[9];
+        for (int j = 0; j < 9; j++)
+            coeff[j] = taps[k * 9 + j];
+        cv::Mat filter(3, 3, CV_32F, coeff);
+        cv::filter2D(luma, temp, CV_8U, filter, cv::Point(-1, -1), 0,
+                     cvBorders[(int)border]);
+        luma = temp.clone();
+    }
+
+    memcpy(dst, src, frameBytes(fmt, width, height));
+    for (size_t i = 0; i < luma.total(); i++)
+        dst[i * step] = luma.data[i];
+}
+
+} // namespace f2d
@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "border.hpp"
+#include "pixel_format.hpp"
+#include <stdint.h>
+
+namespace f2d {
+
+/*
+ * OpenCV reference of the filter paths. Every stage of the chain (stages x
+ * 9 taps, first stage first) is applied to the luma samples with
+ * cv::filter2D, saturating to 8 bit; chroma samples are passed through.
+ * border is the one of the implementation under test, see
+ * FilterWorker::border().
+ */
+void referenceFilter(const uint8_t *src, uint8_t *dst, int width, int height,
+                     PixelFormat fmt, const int16_t *taps, int stages,
+                     BorderMode border);
+
+} // namespace f2d
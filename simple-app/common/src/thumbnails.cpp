@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "thumbnails.hpp"
+#include "frame_compare.hpp"
+#include "frame_io.hpp"
+#include "mosaic.hpp"
+#include "reference.hpp"
+#include <chrono>
+#include <iostream>
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <string.h>
+
+namespace f2d {
+
+int runThumbnails(const std::string &pattern, FilterWorker &filterer,
+                  const std::vector<int16_t> &taps, int atlasWidth,
+                  int atlasHeight) {
+    const int repeat = 10;
+    std::vector<std::string> files;
+    std::vector<cv::Mat> images, single, batched;
+    cv::Mat ref;
+    int errCount;
+
+    cv::glob(pattern, files);
+    for (const std::string &f : files) {
+        cv::Mat img = cv::imread(f, cv::IMREAD_COLOR);
+        if (img.data == NULL || img.cols < 2)
+            continue;
+        // the device buffers and the atlas hold at most one full frame
+        if (img.cols > atlasWidth || img.rows > atlasHeight) {
+            std::cout << "Skipping " << f << ", larger than " << atlasWidth
+                      << "x" << atlasHeight << std::endl;
+            continue;
+        }
+        // YUYV needs an even number of columns
+        cv::Mat yuyv(img.rows, img.cols & ~1, CV_8UC2);
+        convertBgrFrame(img(cv::Rect(0, 0, yuyv.cols, yuyv.rows)), yuyv.data,
+                        PixelFormat::YUYV, yuyv.cols, yuyv.rows);
+        images.push_back(yuyv);
+    }
+    if (images.empty()) {
+        std::cerr << "No images found matching " << pattern << std::endl;
+        return -1;
+    }
+    std::cout << "Thumbnails: " << images.size() << " images" << std::endl;
+    for (const cv::Mat &img : images) {
+        single.push_back(cv::Mat(img.rows, img.cols, CV_8UC2));
+        batched.push_back(cv::Mat(img.rows, img.cols, CV_8UC2));
+    }
+
+    // one launch per image
+    auto t0 = std::chrono::steady_clock::now();
+    for (int n = 0; n < repeat; n++) {
+        for (size_t i = 0; i < images.size(); i++)
+            filterer.filterBand(images[i].data, single[i].data,
+                                images[i].cols, images[i].rows,
+                                RowBand{0, images[i].rows});
+    }
+    std::chrono::duration<double> perImage =
+        std::chrono::steady_clock::now() - t0;
+
+    // one launch per mosaic, images too large for the atlas go alone
+    cv::Mat atlas(atlasHeight, atlasWidth, CV_8UC2);
+    cv::Mat atlasOut(atlasHeight, atlasWidth, CV_8UC2);
+    MosaicPacker packer(atlasWidth, atlasHeight);
+    std::vector<MosaicSlot> slots(images.size());
+    int launches = 0;
+    t0 = std::chrono::steady_clock::now();
+    for (int n = 0; n < repeat; n++) {
+        size_t first = 0;
+        while (first < images.size()) {
+            size_t last = first;
+            packer.reset();
+            while (last < images.size() &&
+                   packer.add(images[last].cols, images[last].rows,
+                              &slots[last])) {
+                mosaicPack(images[last].data, atlas.data, atlasWidth,
+                           atlasHeight, slots[last], filterer.border());
+                last++;
+            }
+            if (last == first) {
+                filterer.filterBand(images[first].data, batched[first].data,
+                                    images[first].cols, images[first].rows,
+                                    RowBand{0, images[first].rows});
+                last = first + 1;
+            } else {
+                filterer.filterBand(atlas.data, atlasOut.data, atlasWidth,
+                                    atlasHeight,
+                                    RowBand{0, packer.usedRows()});
+                for (size_t i = first; i < last; i++)
+                    mosaicUnpack(atlasOut.data, atlasWidth, slots[i],
+                                 batched[i].data);
+            }
+            launches++;
+            first = last;
+        }
+    }
+    std::chrono::duration<double> perMosaic =
+        std::chrono::steady_clock::now() - t0;
+
+    errCount = 0;
+    for (size_t i = 0; i < images.size(); i++) {
+        size_t bytes = images[i].total() * images[i].elemSize();
+        ref.create(images[i].rows, images[i].cols, CV_8UC2);
+        referenceFilter(images[i].data, ref.data, images[i].cols,
+                        images[i].rows, PixelFormat::YUYV, taps.data(),
+                        taps.size() / 9, filterer.border());
+        size_t mismatch = compareFrames(batched[i].data, ref.data, bytes);
+        reportCompare(std::cout, mismatch, bytes);
+        if (memcmp(single[i].data, batched[i].data, bytes) || mismatch)
+            errCount++;
+    }
+
+    std::cout << "Per-image launches: "
+              << images.size() * repeat / perImage.count() << " images/s"
+              << std::endl;
+    std::cout << "Mosaic launches:    "
+              << images.size() * repeat / perMosaic.count() << " images/s, "
+              << launches / repeat << " launches for " << images.size()
+              << " images" << std::endl;
+    if (errCount)
+        std::cout << "Result: Mosaic failed for " << errCount << "/"
+                  << images.size() << " images" << std::endl;
+    else
+        std::cout << "Result: Mosaic matches per-image results" << std::endl;
+    return 0;
+}
+
+} // namespace f2d
@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "hetero_scheduler.hpp"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace f2d {
+
+/*
+ * Filter every image matching pattern at its native size, once with one
+ * launch per image and once packed into atlasWidth x atlasHeight mosaics
+ * with one launch per mosaic, and report images/s of both. The mosaic
+ * results must match the per-image results bit by bit and the OpenCV
+ * reference of each image (taps holds 9 taps per stage), with the border
+ * mode of the filterer. Images larger than the atlas are skipped. Returns
+ * -1 if no image matched.
+ */
+int runThumbnails(const std::string &pattern, FilterWorker &filterer,
+                  const std::vector<int16_t> &taps, int atlasWidth,
+                  int atlasHeight);
+
+} // namespace f2d
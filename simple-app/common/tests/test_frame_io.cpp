@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Unit tests of the OpenCV host library: frame sources, BGR conversion,
+ * frame dumps, the cv::filter2D reference and the host pipeline. Frames
+ * are written below obj/, run from the common directory.
+ */
+
+#include "cpu_filter.hpp"
+#include "filter_presets.hpp"
+#include "frame_compare.hpp"
+#include "frame_io.hpp"
+#include "host_pipeline.hpp"
+#include "placement.hpp"
+#include "reference.hpp"
+#include <iostream>
+#include <opencv2/imgcodecs.hpp>
+#include <stdio.h>
+#include <vector>
+
+static int checks = 0;
+static int failed = 0;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        checks++;                                                              \
+        if (!(cond)) {                                                         \
+            failed++;                                                          \
+            std::cout << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond       \
+                      << ") failed" << std::endl;                              \
+        }                                                                      \
+    } while (0)
+
+static const int WIDTH = 64;
+static const int HEIGHT = 48;
+
+static cv::Mat testImage(int seed) {
+    cv::Mat bgr(HEIGHT, WIDTH, CV_8UC3);
+    for (int y = 0; y < HEIGHT; y++) {
+        uint8_t *row = bgr.ptr(y);
+        for (int x = 0; x < WIDTH * 3; x++)
+            row[x] = (uint8_t)(x * 7 + y * 13 + seed * 31);
+    }
+    return bgr;
+}
+
+static bool sameMat(const cv::Mat &a, const cv::Mat &b) {
+    if (a.size() != b.size() || a.type() != b.type())
+        return false;
+    for (int y = 0; y < a.rows; y++) {
+        if (f2d::compareFrames(a.ptr(y), b.ptr(y), a.cols * a.elemSize(), 0))
+            return false;
+    }
+    return true;
+}
+
+static void testSingleImage() {
+    cv::Mat img = testImage(0), frame;
+
+    CHECK(cv::imwrite("obj/single.png", img));
+    f2d::FrameSource source("obj/single.png", false);
+    CHECK(source.isOpened());
+    CHECK(source.read(frame));
+    CHECK(sameMat(frame, img));
+    CHECK(!source.read(frame)); // a stream of one frame
+}
+
+static void testImageSequence() {
+    const int frames = 3;
+    char path[64];
+    cv::Mat frame;
+
+    for (int i = 0; i < frames; i++) {
+        snprintf(path, sizeof(path), "obj/seq_%04d.png", i);
+        CHECK(cv::imwrite(path, testImage(i)));
+    }
+    f2d::FrameSource source("obj/seq_%04d.png", true);
+    CHECK(source.isOpened());
+    for (int i = 0; i < frames; i++) {
+        CHECK(source.read(frame));
+        CHECK(sameMat(frame, testImage(i)));
+    }
+    CHECK(!source.read(frame));
+}
+
+static void testMissingInput() {
+    CHECK(!f2d::FrameSource("obj/missing.png", false).isOpened());
+    CHECK(!f2d::FrameSource("obj/missing_%04d.png", true).isOpened());
+}
+
+static void testConvertBgr() {
+    const f2d::PixelFormat formats[] = {
+        f2d::PixelFormat::BGR, f2d::PixelFormat::YUYV, f2d::PixelFormat::NV12,
+        f2d::PixelFormat::NV16, f2d::PixelFormat::GRAY8};
+    cv::Mat img = testImage(1);
+
+    for (f2d::PixelFormat fmt : formats) {
+        size_t bytes = f2d::frameBytes(fmt, WIDTH, HEIGHT);
+        std::vector<uint8_t> got(bytes), want(bytes);
+
+        f2d::convertBgrFrame(img, got.data(), fmt, WIDTH, HEIGHT);
+        f2d::convertFrame(img.ptr(), f2d::PixelFormat::BGR, want.data(), fmt,
+                          WIDTH, HEIGHT);
+        CHECK(f2d::compareFrames(got.data(), want.data(), bytes, 0) == 0);
+    }
+
+    // a frame of another size is resized first
+    cv::Mat large, small;
+    std::vector<uint8_t> got(WIDTH * HEIGHT), want(WIDTH * HEIGHT);
+    cv::resize(img, large, cv::Size(WIDTH * 2, HEIGHT * 2));
+    cv::resize(large, small, cv::Size(WIDTH, HEIGHT), 0, 0, cv::INTER_LINEAR);
+    f2d::convertBgrFrame(large, got.data(), f2d::PixelFormat::GRAY8, WIDTH,
+                         HEIGHT);
+    f2d::convertFrame(small.ptr(), f2d::PixelFormat::BGR, want.data(),
+                      f2d::PixelFormat::GRAY8, WIDTH, HEIGHT);
+    CHECK(f2d::compareFrames(got.data(), want.data(), got.size(), 0) == 0);
+}
+
+static void testDumpFrame() {
+    std::vector<uint8_t> gray(WIDTH * HEIGHT), back(WIDTH * HEIGHT);
+    cv::Mat bgr;
+
+    for (int i = 0; i < WIDTH * HEIGHT; i++)
+        gray[i] = (uint8_t)(i * 5);
+    CHECK(f2d::dumpFrame("obj/dump.png", gray.data(),
+                         f2d::PixelFormat::GRAY8, WIDTH, HEIGHT));
+    bgr = cv::imread("obj/dump.png");
+    CHECK(bgr.rows == HEIGHT && bgr.cols == WIDTH);
+    if (bgr.rows != HEIGHT || bgr.cols != WIDTH)
+        return;
+    // gray -> BGR -> gray is lossless, PNG too
+    f2d::convertBgrFrame(bgr, back.data(), f2d::PixelFormat::GRAY8, WIDTH,
+                         HEIGHT);
+    CHECK(f2d::compareFrames(gray.data(), back.data(), gray.size(), 0) == 0);
+}
+
+/* The reference and the CPU filter agree in every border mode */
+static void testReference() {
+    const f2d::BorderMode borders[] = {f2d::BorderMode::CONSTANT,
+                                       f2d::BorderMode::REPLICATE,
+                                       f2d::BorderMode::REFLECT_101};
+    const f2d::PixelFormat fmt = f2d::PixelFormat::GRAY8;
+    size_t bytes = f2d::frameBytes(fmt, WIDTH, HEIGHT);
+    std::vector<uint8_t> src(bytes), out(bytes), ref(bytes);
+    cv::Mat img = testImage(2);
+
+    f2d::convertBgrFrame(img, src.data(), fmt, WIDTH, HEIGHT);
+    for (int p = 0; p < f2d::filterPresetCount; p++) {
+        const int16_t *taps = f2d::filterPresets[p].taps;
+        for (f2d::BorderMode border : borders) {
+            f2d::filterFrame(src.data(), out.data(), WIDTH, HEIGHT, fmt, taps,
+                             border);
+            f2d::referenceFilter(src.data(), ref.data(), WIDTH, HEIGHT, fmt,
+                                 taps, 1, border);
+            CHECK(f2d::compareFrames(out.data(), ref.data(), bytes, 0) == 0);
+        }
+    }
+}
+
+/*
+ * Chains of 2 and 3 consecutive presets: the single pass of filterChain
+ * saturates after every stage like the stage by stage reference does
+ */
+static void testReferenceChain() {
+    const f2d::PixelFormat formats[] = {f2d::PixelFormat::GRAY8,
+                                        f2d::PixelFormat::YUYV};
+    const f2d::BorderMode borders[] = {f2d::BorderMode::CONSTANT,
+                                       f2d::BorderMode::REPLICATE,
+                                       f2d::BorderMode::REFLECT_101};
+    cv::Mat img = testImage(3);
+
+    for (f2d::PixelFormat fmt : formats) {
+        size_t bytes = f2d::frameBytes(fmt, WIDTH, HEIGHT);
+        std::vector<uint8_t> src(bytes), out(bytes), ref(bytes);
+
+        f2d::convertBgrFrame(img, src.data(), fmt, WIDTH, HEIGHT);
+        for (int stages = 2; stages <= 3; stages++) {
+            for (int p = 0; p < f2d::filterPresetCount; p++) {
+                std::vector<int16_t> taps;
+                for (int k = 0; k < stages; k++) {
+                    const f2d::FilterPreset &stage =
+                        f2d::filterPresets[(p + k) % f2d::filterPresetCount];
+                    taps.insert(taps.end(), stage.taps, stage.taps + 9);
+                }
+                for (f2d::BorderMode border : borders) {
+                    f2d::filterChain(src.data(), out.data(), WIDTH, HEIGHT,
+                                     fmt, taps.data(), stages, border);
+                    f2d::referenceFilter(src.data(), ref.data(), WIDTH,
+                                         HEIGHT, fmt, taps.data(), stages,
+                                         border);
+                    CHECK(f2d::compareFrames(out.data(), ref.data(), bytes,
+                                             0) == 0);
+                }
+            }
+        }
+    }
+}
+
+/* Frames reach the filter and the report in order and are validated */
+static void testHostPipeline() {
+    const f2d::PixelFormat fmt = f2d::PixelFormat::GRAY8;
+    const int16_t *taps = f2d::filterPresets[0].taps;
+    std::vector<int> reported;
+    char path[64];
+
+    for (int i = 0; i < 3; i++) {
+        snprintf(path, sizeof(path), "obj/pipe_%04d.png", i);
+        CHECK(cv::imwrite(path, testImage(i)));
+    }
+    for (bool broken : {false, true}) {
+        f2d::FrameSource source("obj/pipe_%04d.png", true);
+        f2d::PlacementPolicy placement;
+        f2d::HostPipeline pipeline(source, placement, fmt, WIDTH, HEIGHT, 2);
+
+        reported.clear();
+        pipeline.setReference(taps, 1, f2d::BorderMode::CONSTANT);
+        pipeline.setFilter("cpu", [&](size_t, const uint8_t *in,
+                                      uint8_t *out) {
+            f2d::filterFrame(in, out, WIDTH, HEIGHT, fmt, taps);
+            if (broken)
+                out[0] ^= 0x80;
+        });
+        pipeline.setReport(
+            [&](size_t, int index) { reported.push_back(index); });
+        CHECK(pipeline.run() == 3);
+        CHECK(reported == std::vector<int>({0, 1, 2}));
+        CHECK(pipeline.failedFrames() == (broken ? 3 : 0));
+    }
+}
+
+int main() {
+    testSingleImage();
+    testImageSequence();
+    testMissingInput();
+    testConvertBgr();
+    testDumpFrame();
+    testReference();
+    testReferenceChain();
+    testHostPipeline();
+
+    std::cout << "Result: " << checks - failed << "/" << checks
+              << " checks passed" << std::endl;
+    return failed ? 1 : 0;
+}
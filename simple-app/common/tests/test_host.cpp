@@ -0,0 +1,383 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Unit tests of the core host library, which builds without XRT and
+ * OpenCV: the bounded queue and pipeline runner, the load balancing of the
+ * worker pool, CPU list and core set parsing, the metrics registry, the
+ * dirty region accounting, the frame comparison and the shared command
+ * line options.
+ */
+
+#include "dirty_region.hpp"
+#include "filter_presets.hpp"
+#include "frame_compare.hpp"
+#include "hetero_scheduler.hpp"
+#include "host_options.hpp"
+#include "metrics.hpp"
+#include "pipeline.hpp"
+#include "placement.hpp"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+static int checks = 0;
+static int failed = 0;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        checks++;                                                              \
+        if (!(cond)) {                                                         \
+            failed++;                                                          \
+            std::cout << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond       \
+                      << ") failed" << std::endl;                              \
+        }                                                                      \
+    } while (0)
+
+static void testQueueOrder() {
+    f2d::BoundedQueue<int> q(4);
+    int v = -1;
+
+    for (int i = 0; i < 4; i++)
+        q.push(i);
+    for (int i = 0; i < 4; i++) {
+        CHECK(q.pop(&v));
+        CHECK(v == i);
+    }
+    q.push(7);
+    q.close();
+    CHECK(q.pop(&v) && v == 7); // drained after close
+    CHECK(!q.pop(&v));
+}
+
+static void testQueueBlocks() {
+    f2d::BoundedQueue<int> q(2);
+    std::atomic<bool> pushed(false);
+    int v;
+
+    q.push(0);
+    q.push(1);
+    std::thread producer([&] {
+        q.push(2);
+        pushed = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK(!pushed); // full, push waits
+    CHECK(q.pop(&v) && v == 0);
+    producer.join();
+    CHECK(pushed);
+
+    std::thread consumer([&] { CHECK(q.pop(&v) && v == 1); });
+    consumer.join();
+    CHECK(q.pop(&v) && v == 2);
+
+    std::atomic<bool> woken(false);
+    std::thread waiter([&] {
+        int x;
+        CHECK(!q.pop(&x));
+        woken = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    q.close(); // wakes the blocked pop
+    waiter.join();
+    CHECK(woken);
+}
+
+/*
+ * Every frame passes every stage exactly once and in order, holding a slot
+ * of the pool throughout, and the gauges are back at zero once it ends
+ */
+static void testPipeline(size_t slots) {
+    const int frames = 100;
+    f2d::HostMetrics &stats = f2d::hostMetrics();
+    std::vector<int> frameOf(slots, -1);
+    std::vector<int> seen;
+    int next = 0;
+    int converted = 0;
+    bool ordered = true;
+    bool pooled = true;
+
+    f2d::Pipeline pipeline(slots);
+    pipeline.setSource("decode", f2d::ThreadRole::DECODE, [&](size_t s) {
+        if (next == frames)
+            return false;
+        frameOf[s] = next++;
+        return true;
+    });
+    pipeline.addStage("convert", f2d::ThreadRole::CONVERT, [&](size_t s) {
+        ordered = ordered && frameOf[s] == converted++;
+        frameOf[s] += 1000;
+        // a taken slot leaves the free count before it enters the in
+        // flight count and the reverse on its way back, so neither can
+        // overshoot while this frame holds its slot
+        int64_t inFlight = stats.slotsInFlight.value();
+        int64_t free = stats.freeSlots.value();
+        pooled = pooled && inFlight >= 1 && inFlight <= (int64_t)slots &&
+                 free >= 0 && free < (int64_t)slots;
+    });
+    pipeline.addStage("write", f2d::ThreadRole::WRITER,
+                      [&](size_t s) { seen.push_back(frameOf[s] - 1000); });
+
+    CHECK(pipeline.run() == (uint64_t)frames);
+    CHECK(ordered);
+    CHECK((int)seen.size() == frames);
+    for (int i = 0; i < (int)seen.size(); i++)
+        CHECK(seen[i] == i);
+    CHECK(pooled);
+    CHECK(stats.pipelineQueue.value() == 0);
+    CHECK(stats.slotsInFlight.value() == 0);
+    CHECK(stats.freeSlots.value() == 0);
+}
+
+static void testPipelineEmpty() {
+    int stageRuns = 0;
+    f2d::Pipeline pipeline(3);
+
+    pipeline.setSource("decode", f2d::ThreadRole::DECODE,
+                       [](size_t) { return false; });
+    pipeline.addStage("write", f2d::ThreadRole::WRITER,
+                      [&](size_t) { stageRuns++; });
+    CHECK(pipeline.run() == 0);
+    CHECK(stageRuns == 0);
+}
+
+/*
+ * A device 20ms slower per launch than the CPU worker beside it ends up
+ * with a small share of the rows, around 15% of a 1080p frame, but never
+ * less than its granule per frame
+ */
+static void testSchedulerShares() {
+    const int width = 1920;
+    const int height = 1080;
+    const int frames = 10;
+    const int16_t *taps = f2d::filterPresets[0].taps;
+    std::vector<uint8_t> src((size_t)width * height * 2, 77);
+    std::vector<uint8_t> dst(src.size());
+    f2d::StandInDevice slow(taps, 20000);
+    f2d::CpuWorker cpu(taps);
+    f2d::HeteroScheduler scheduler({&slow, &cpu});
+
+    for (int n = 0; n < frames; n++)
+        scheduler.run(src.data(), dst.data(), width, height,
+                      f2d::RowBand{0, height});
+    uint64_t slowRows = scheduler.rowsDone(0);
+    uint64_t cpuRows = scheduler.rowsDone(1);
+    CHECK(slowRows + cpuRows == (uint64_t)height * frames);
+    CHECK(slowRows >= 8 * frames);
+    CHECK(slowRows < 0.3 * (slowRows + cpuRows));
+    CHECK(f2d::hostMetrics().workerBands.value() == 0);
+}
+
+static bool cpuList(const std::string &list, std::vector<int> expected) {
+    std::vector<int> cpus;
+    return f2d::parseCpuList(list, &cpus) && cpus == expected;
+}
+
+static bool badCpuList(const std::string &list) {
+    std::vector<int> cpus;
+    return !f2d::parseCpuList(list, &cpus);
+}
+
+static void testParseCpuList() {
+    CHECK(cpuList("3", {3}));
+    CHECK(cpuList("0-3", {0, 1, 2, 3}));
+    CHECK(cpuList("0-1,8,10-11", {0, 1, 8, 10, 11}));
+    CHECK(cpuList("5-5", {5}));
+    CHECK(badCpuList(""));
+    CHECK(badCpuList("x"));
+    CHECK(badCpuList("-1"));
+    CHECK(badCpuList("3-1"));
+    CHECK(badCpuList("0-"));
+    CHECK(badCpuList("1,,2"));
+    CHECK(badCpuList("1,2,"));
+    CHECK(badCpuList("1-2x"));
+    CHECK(badCpuList("1:2"));
+}
+
+/* Roles take their own core sets, the others the cores of the node */
+static void testPlacementParse() {
+    f2d::PlacementPolicy placement(0);
+    CHECK(placement.parse("decode=0-1:writer=2,3"));
+    CHECK(placement.cpus(f2d::ThreadRole::DECODE) == std::vector<int>({0, 1}));
+    CHECK(placement.cpus(f2d::ThreadRole::WRITER) == std::vector<int>({2, 3}));
+    CHECK(placement.cpus(f2d::ThreadRole::SUBMIT) == f2d::nodeCpus(0));
+    // a later spec replaces the set of a role
+    CHECK(placement.parse("decode=4"));
+    CHECK(placement.cpus(f2d::ThreadRole::DECODE) == std::vector<int>({4}));
+    // no node, no fallback: roles without cores stay unpinned
+    CHECK(f2d::PlacementPolicy().cpus(f2d::ThreadRole::CONVERT).empty());
+
+    CHECK(f2d::PlacementPolicy().parse(""));
+    for (const char *spec : {"gpu=1", "decoder=1", "dec=1", "decode",
+                             "decode=", "decode=x", "decode=1:", ":decode=1",
+                             "submit=1;writer=2"})
+        CHECK(!f2d::PlacementPolicy().parse(spec));
+}
+
+/* HELP and TYPE once per name, then every series of it with its labels */
+static void testMetricsRender() {
+    f2d::MetricsRegistry registry;
+    registry.counter("t_frames_total", "Frames done").add(3);
+    registry.gauge("t_bands", "Bands", "worker=\"cpu\"").set(-2);
+    registry.gauge("t_bands", "Bands", "worker=\"dev\"").set(5);
+    f2d::Histogram &lat =
+        registry.histogram("t_latency_seconds", "Latency", {1000, 1000000});
+    lat.observe(500);
+    lat.observe(2000000);
+    // the same name and labels give the same series
+    registry.counter("t_frames_total", "Frames done").add(1);
+
+    CHECK(registry.render() ==
+          "# HELP t_frames_total Frames done\n"
+          "# TYPE t_frames_total counter\n"
+          "t_frames_total 4\n"
+          "# HELP t_bands Bands\n"
+          "# TYPE t_bands gauge\n"
+          "t_bands{worker=\"cpu\"} -2\n"
+          "t_bands{worker=\"dev\"} 5\n"
+          "# HELP t_latency_seconds Latency\n"
+          "# TYPE t_latency_seconds histogram\n"
+          "t_latency_seconds_bucket{le=\"1e-06\"} 1\n"
+          "t_latency_seconds_bucket{le=\"0.001\"} 1\n"
+          "t_latency_seconds_bucket{le=\"+Inf\"} 2\n"
+          "t_latency_seconds_sum 0.0020005\n"
+          "t_latency_seconds_count 2\n");
+}
+
+/* A name keeps the type it was first registered with, whatever the labels */
+static void testMetricsTypeMismatch() {
+    f2d::MetricsRegistry registry;
+    registry.counter("t_frames_total", "Frames done");
+
+    for (const char *labels : {"", "worker=\"cpu\""}) {
+        bool threw = false;
+        try {
+            registry.gauge("t_frames_total", "Frames done", labels);
+        } catch (const std::logic_error &) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+    bool threw = false;
+    try {
+        registry.histogram("t_frames_total", "Frames done", {1000});
+    } catch (const std::logic_error &) {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK(registry.render().find("t_frames_total 0\n") != std::string::npos);
+}
+
+/* Rows and bytes of the dirty bands, counted per frame and in total */
+static void testDirtyStats() {
+    const int height = 64;
+    const size_t rowBytes = 16;
+    std::vector<uint8_t> frame(height * rowBytes, 0);
+    f2d::DirtyRegionTracker tracker(height, rowBytes, 8);
+
+    tracker.update(frame.data()); // the first frame is dirty as a whole
+    CHECK(tracker.lastFrameStats().filteredRows == height);
+    CHECK(tracker.lastFrameStats().movedBytes == 2 * height * rowBytes);
+    tracker.update(frame.data());
+    CHECK(tracker.lastFrameStats().skippedFrames == 1);
+    CHECK(tracker.lastFrameStats().filteredRows == 0);
+    CHECK(tracker.lastFrameStats().movedBytes == 0);
+    // stripe [16, 24) plus the halo, read with a halo of its own
+    frame[20 * rowBytes] = 1;
+    tracker.update(frame.data());
+    CHECK(tracker.lastFrameStats().filteredRows == 10);
+    CHECK(tracker.lastFrameStats().movedBytes == (12 + 10) * rowBytes);
+
+    const f2d::DirtyStats &st = tracker.stats();
+    CHECK(st.frames == 3 && st.skippedFrames == 1);
+    CHECK(st.fullRows == 3 * height && st.filteredRows == height + 10);
+    CHECK(st.fullBytes == 3 * 2 * height * rowBytes);
+}
+
+static void testCompareFrames() {
+    // lengths around the 16 byte SIMD width exercise the scalar tail
+    for (size_t bytes : {1, 15, 16, 17, 33, 1000}) {
+        std::vector<uint8_t> a(bytes), b;
+        for (size_t i = 0; i < bytes; i++)
+            a[i] = (uint8_t)(2 + i * 37 % 250); // +-2 never wraps
+        b = a;
+        CHECK(f2d::compareFrames(a.data(), b.data(), bytes) == 0);
+
+        b[0] = a[0] + 1; // within the default tolerance
+        b[bytes - 1] = a[bytes - 1] - 1;
+        CHECK(f2d::compareFrames(a.data(), b.data(), bytes) == 0);
+        CHECK(f2d::compareFrames(a.data(), b.data(), bytes, 0) ==
+              (bytes > 1 ? 2u : 1u));
+
+        b[bytes / 2] = a[bytes / 2] + 2;
+        CHECK(f2d::compareFrames(a.data(), b.data(), bytes) == 1);
+        CHECK(f2d::compareFrames(b.data(), a.data(), bytes) == 1);
+    }
+
+    // differences across the full sample range
+    uint8_t lo[16] = {0}, hi[16];
+    for (int i = 0; i < 16; i++)
+        hi[i] = 255;
+    CHECK(f2d::compareFrames(lo, hi, 16) == 16);
+    CHECK(f2d::compareFrames(lo, hi, 16, 254) == 16);
+    CHECK(f2d::compareFrames(lo, hi, 16, 255) == 0);
+}
+
+static int parse(std::vector<const char *> args, f2d::HostOptions &opts) {
+    args.insert(args.begin(), "host.elf");
+    return f2d::parseHostOption((int)args.size(), (char **)args.data(), 1,
+                                opts);
+}
+
+static void testHostOptions() {
+    f2d::HostOptions opts("default.xclbin");
+
+    CHECK(opts.userXclbin == "default.xclbin");
+    CHECK(opts.queueDepth == 3);
+    CHECK(parse({"-q", "5"}, opts) == 2 && opts.queueDepth == 5);
+    CHECK(parse({"-q", "0"}, opts) == -1);
+    CHECK(parse({"-p", "NV12"}, opts) == 2 &&
+          opts.format == f2d::PixelFormat::NV12);
+    CHECK(parse({"-p", "BGR"}, opts) == -1);
+    CHECK(parse({"-p", "RGB"}, opts) == -1);
+    CHECK(parse({"-v", "cam.mp4"}, opts) == 2 && opts.inputVideo == "cam.mp4");
+    CHECK(parse({"-d", "16"}, opts) == 0); // left to the host
+    CHECK(parse({"-i"}, opts) == 0);       // value missing
+}
+
+int main() {
+    testQueueOrder();
+    testQueueBlocks();
+    for (size_t slots : {1, 2, 4})
+        testPipeline(slots);
+    testPipelineEmpty();
+    testSchedulerShares();
+    testParseCpuList();
+    testPlacementParse();
+    testMetricsRender();
+    testMetricsTypeMismatch();
+    testDirtyStats();
+    testCompareFrames();
+    testHostOptions();
+
+    std::cout << "Result: " << checks - failed << "/" << checks
+              << " checks passed" << std::endl;
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2019-2022 Xilinx, Inc
+ * Copyright (C) 2022-2024 Advance Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define PROFILE
+#define int64 INT164
+#define uint64 UINT164
+
+#include "aie_worker.hpp"
+#include "metrics.hpp"
+#include <chrono>
+#include <common/xf_aie_sw_utils.hpp>
+#include <common/xfcvDataMovers.h>
+#include <iostream>
+#include <string.h>
+#include <xrt/xrt_device.h>
+
+/* Graph specific configuration */
+static constexpr int VECTORIZATION_FACTOR = 16;
+static constexpr int TILE_WIDTH = 128;
+static constexpr int TILE_HEIGHT = 16;
+
+using Tiler = xF::xfcvDataMovers<xF::TILER, int16_t, TILE_HEIGHT, TILE_WIDTH,
+                                 VECTORIZATION_FACTOR>;
+using Stitcher = xF::xfcvDataMovers<xF::STITCHER, int16_t, TILE_HEIGHT,
+                                    TILE_WIDTH, VECTORIZATION_FACTOR>;
+
+struct AieWorker::Device {
+    Device(int width, int height)
+        : size(width, height), bytes((size_t)width * height * 2),
+          src(xF::gpDhdl, bytes, 0, 0), dst(xF::gpDhdl, bytes, 0, 0),
+          tiler(1, 1) {}
+
+    cv::Size size;
+    size_t bytes;
+    xrt::bo src;
+    xrt::bo dst;
+    Tiler tiler;
+    Stitcher stitcher;
+};
+
+AieWorker::AieWorker() : kernelNs(0) {}
+
+AieWorker::~AieWorker() {}
+
+bool AieWorker::init(const std::string &xclbin, int width, int height) {
+    std::cout << "Loading xclbin " << std::endl;
+    xF::deviceInit(xclbin.c_str());
+    mBdf = xrt::device(xF::gpDhdl).get_info<xrt::info::device::bdf>();
+
+    std::cout << "Creating input and output buffers..." << std::endl;
+    mDev.reset(new Device(width, height));
+    f2d::hostMetrics().deviceBufferBytes.set(2 * mDev->bytes);
+
+    std::cout << "Initializing Tiler & Stitcher.\n";
+    START_TIMER
+    mDev->tiler.compute_metadata(mDev->size);
+    STOP_TIMER("Meta data compute time")
+    return true;
+}
+
+void AieWorker::filterBand(const uint8_t *src, uint8_t *dst, int width,
+                           int height, f2d::RowBand band) {
+    f2d::HostMetrics &stats = f2d::hostMetrics();
+    size_t rowBytes = (size_t)width * 2;
+
+    memcpy(mDev->src.map(), src, mDev->bytes);
+    mDev->src.sync(XCL_BO_SYNC_BO_TO_DEVICE, mDev->bytes, 0);
+
+    START_TIMER
+    auto tiles_sz = mDev->tiler.host2aie_nb(&mDev->src, mDev->size);
+    mDev->stitcher.aie2host_nb(&mDev->dst, mDev->size, tiles_sz);
+    mDev->tiler.wait();
+    mDev->stitcher.wait();
+    mDev->dst.sync(XCL_BO_SYNC_BO_FROM_DEVICE, mDev->bytes, 0);
+    STOP_TIMER("yuy2 filter2D function")
+
+    long long ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(tdiff).count();
+    kernelNs += ns;
+    stats.kernelTime.observe(ns);
+    stats.bytesToDevice.add(mDev->bytes);
+    stats.bytesFromDevice.add(mDev->bytes);
+
+    memcpy(dst + band.begin * rowBytes,
+           (const uint8_t *)mDev->dst.map() + band.begin * rowBytes,
+           (band.end - band.begin) * rowBytes);
+}
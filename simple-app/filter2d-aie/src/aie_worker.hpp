@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2019-2022 Xilinx, Inc
+ * Copyright (C) 2022-2024 Advance Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "hetero_scheduler.hpp"
+#include <memory>
+#include <stdint.h>
+#include <string>
+
+/*
+ * The filter2d AIE graph as a device backend. Frames are moved to and from
+ * the graph by the tiler and stitcher data movers, which always process the
+ * whole frame: a band is produced by filtering the frame and keeping the
+ * rows of the band. The graph applies fixed Edge coefficients and replicates
+ * the frame border.
+ */
+class AieWorker : public f2d::FilterWorker {
+  public:
+    AieWorker();
+    ~AieWorker();
+
+    /* Program the xclbin and allocate the buffers for YUYV frames of
+     * width x height */
+    bool init(const std::string &xclbin, int width, int height);
+
+    const char *name() const override { return "filter2d_aie"; }
+    const std::string &bdf() const { return mBdf; } // PCIe address
+    f2d::BorderMode border() const override {
+        return f2d::BorderMode::REPLICATE;
+    }
+    void filterBand(const uint8_t *src, uint8_t *dst, int width, int height,
+                    f2d::RowBand band) override;
+
+    double kernelNs; // accumulated tiler to stitcher time
+
+  private:
+    struct Device; // the XRT objects, kept out of the header
+    std::unique_ptr<Device> mDev;
+    std::string mBdf;
+};
@@ -0,0 +1,764 @@
+/*
+ * Copyright (C) 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpu_filter.hpp"
+#include "dirty_region.hpp"
+#include "filter_presets.hpp"
+#include "hetero_scheduler.hpp"
+#include "metrics.hpp"
+#include "mosaic.hpp"
+#include "pixel_format.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/* Frame sizes every filter is measured at */
+static const int frameSizes[][2] = {{640, 480}, {1280, 720}, {1920, 1080}};
+
+/*
+ * Latency of the accelerator stand-in per launch, in runs of the
+ * calibration loop over the frame. Scaled like this, the stand-in keeps the
+ * same weight against its CPU worker on fast and slow machines, so the
+ * relative throughput of the stand-in cases does not depend on the machine.
+ */
+static constexpr double STAND_IN_CALIBRATIONS = 1;
+
+/* Timed rounds per case, each runs at least this long */
+static constexpr int ROUNDS = 7;
+static constexpr double MIN_ROUND_MS = 100;
+
+/* Budget for the metrics updates of one frame */
+static constexpr double METRICS_BUDGET_NS = 1000;
+
+struct Result {
+    std::string name; // backend/filter/WxH
+    double fps;
+    double relative; // fps over the calibration loop's, 0 if not recorded
+    double p50Ms;
+    double p95Ms;
+    double p99Ms;
+    uint32_t checksum; // FNV-1a of the last output frame
+};
+
+void printHelp(void) {
+    std::cout
+        << "=================================================" << std::endl
+        << "Filter2d Performance Regression Suite Usage " << std::endl
+        << "=================================================" << std::endl
+        << "<Executable Name> -b [baseline_json] -o [results_json] "
+           "-t [tolerance] -n [frames] -r [runs] -f [filter]"
+        << std::endl
+        << "    -n  minimum frames per round, rounds also run at least "
+        << MIN_ROUND_MS << "ms" << std::endl
+        << "    -r  repeat the suite, every case keeps its median run"
+        << std::endl
+        << "    -u  write the measured results to the baseline instead of "
+           "comparing"
+        << std::endl
+        << "    -x  only run the splitter, format and metrics checks, "
+           "without measuring"
+        << std::endl
+        << std::endl
+        << "Example: filter2d_perf.elf -b baseline.json -t 0.15" << std::endl
+        << std::endl;
+}
+
+/*
+ * Deterministic YUYV test frame: a diagonal luma ramp with a few hard
+ * edges, plus xorshift noise on luma and chroma so that every filter has
+ * work to do. Identical on every machine for a given size.
+ */
+void syntheticFrame(int width, int height, std::vector<uint8_t> &frame) {
+    uint32_t state = 0x9E3779B9u ^ (uint32_t)(width * 31 + height);
+
+    frame.resize((size_t)width * height * 2);
+    for (int r = 0; r < height; r++) {
+        for (int c = 0; c < width; c++) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            int y = (r + c) * 255 / (width + height);
+            if ((r / 64 + c / 64) % 2)
+                y = 255 - y;
+            uint8_t *p = &frame[((size_t)r * width + c) * 2];
+            p[0] = (uint8_t)std::min(y + (int)(state & 15), 255);
+            p[1] = (uint8_t)(128 + (int)((state >> 8) & 31) - 16);
+        }
+    }
+}
+
+uint32_t checksum(const std::vector<uint8_t> &data) {
+    uint32_t h = 2166136261u;
+    for (uint8_t b : data)
+        h = (h ^ b) * 16777619u;
+    return h;
+}
+
+double percentile(std::vector<double> v, double p) {
+    size_t i = std::min((size_t)(p * v.size()), v.size() - 1);
+    std::nth_element(v.begin(), v.begin() + i, v.end());
+    return v[i];
+}
+
+/*
+ * Fixed reference workload: 1-2-1 smoothing of the luma along the rows.
+ * It streams through a frame like a filter does, but lives in this file so
+ * that changes to the host library never move it.
+ */
+void calibrationLoop(const uint8_t *src, uint8_t *dst, size_t bytes) {
+    for (size_t i = 2; i + 2 < bytes; i += 2)
+        dst[i] = (uint8_t)((src[i - 2] + 2 * src[i] + src[i + 2]) >> 2);
+}
+
+/* Median time of the calibration loop over a synthetic frame, in us */
+double calibrationUs(int width, int height) {
+    typedef std::chrono::duration<double, std::micro> Us;
+    size_t bytes = (size_t)width * height * 2;
+    std::vector<uint8_t> src, dst(bytes);
+    std::vector<double> runs;
+
+    syntheticFrame(width, height, src);
+    calibrationLoop(src.data(), dst.data(), bytes);
+    for (int n = 0; n < 15; n++) {
+        auto t0 = std::chrono::steady_clock::now();
+        calibrationLoop(src.data(), dst.data(), bytes);
+        runs.push_back(Us(std::chrono::steady_clock::now() - t0).count());
+    }
+    return percentile(runs, 0.5);
+}
+
+/*
+ * Run filter over one synthetic frame in ROUNDS rounds after a warmup. A
+ * round runs at least frames times and at least MIN_ROUND_MS, so that
+ * timer resolution and short stalls average out; fps is that of the median
+ * round. Every run of the filter follows a run of the calibration loop on a
+ * frame of the same size, so load or clock changes hit both runs of a pair
+ * alike. The relative throughput is the median over all pairs of the
+ * calibration time over the filter time; percentiles are over all runs of
+ * the filter.
+ */
+template <typename F>
+Result measure(const std::string &name, int width, int height, int frames,
+               F filter) {
+    typedef std::chrono::duration<double, std::milli> Ms;
+    size_t bytes = (size_t)width * height * 2;
+    std::vector<uint8_t> src, dst(bytes), scratch(bytes);
+    std::vector<double> latMs, roundFps, ratios;
+
+    syntheticFrame(width, height, src);
+    for (int n = 0; n < 3; n++) {
+        calibrationLoop(src.data(), scratch.data(), bytes);
+        filter(src.data(), dst.data());
+    }
+
+    for (int round = 0; round < ROUNDS; round++) {
+        Ms total(0);
+        int n = 0;
+        while (n < frames || total.count() < MIN_ROUND_MS) {
+            auto t0 = std::chrono::steady_clock::now();
+            calibrationLoop(src.data(), scratch.data(), bytes);
+            auto t1 = std::chrono::steady_clock::now();
+            filter(src.data(), dst.data());
+            auto t2 = std::chrono::steady_clock::now();
+            latMs.push_back(Ms(t2 - t1).count());
+            ratios.push_back(Ms(t1 - t0).count() / latMs.back());
+            total += Ms(t2 - t1);
+            n++;
+        }
+        roundFps.push_back(n * 1000 / total.count());
+    }
+
+    return Result{name,
+                  percentile(roundFps, 0.5),
+                  percentile(ratios, 0.5),
+                  percentile(latMs, 0.50),
+                  percentile(latMs, 0.95),
+                  percentile(latMs, 0.99),
+                  checksum(dst)};
+}
+
+/*
+ * Plain per-sample filter, the border looked up for every tap. Slow, but
+ * independent of the padded lines and SIMD lanes of filterRows().
+ */
+void naiveFilter(const uint8_t *src, uint8_t *dst, int width, int height,
+                 f2d::PixelFormat fmt, const int16_t *taps,
+                 f2d::BorderMode border) {
+    int step = f2d::lumaStep(fmt);
+
+    memcpy(dst, src, (size_t)width * height * step);
+    for (int r = 0; r < height; r++) {
+        for (int c = 0; c < width; c++) {
+            int acc = 0;
+            for (int j = 0; j < 3; j++) {
+                for (int k = 0; k < 3; k++) {
+                    int y = f2d::borderIndex(r + j - 1, height, border);
+                    int x = f2d::borderIndex(c + k - 1, width, border);
+                    if (y >= 0 && x >= 0)
+                        acc += src[((size_t)y * width + x) * step] *
+                               taps[j * 3 + k];
+                }
+            }
+            dst[((size_t)r * width + c) * step] =
+                (uint8_t)std::min(std::max(acc, 0), 255);
+        }
+    }
+}
+
+/*
+ * Check that every way the hosts split a frame gives the bytes of a whole
+ * frame pass: the plain filter, bands in any order, the load balancing
+ * scheduler, fused chains, incremental dirty bands and the mosaic atlas.
+ * Counts the checks and returns the number of failures.
+ */
+int verifyCase(const f2d::FilterPreset &preset, int width, int height,
+               f2d::PixelFormat fmt, f2d::BorderMode border, int *checks) {
+    const int16_t *taps = preset.taps;
+    const int16_t *second = f2d::filterPresets[1].taps;
+    size_t stride = (size_t)width * f2d::lumaStep(fmt);
+    size_t bytes = stride * height;
+    std::vector<uint8_t> src, next, whole(bytes), out(bytes), ref(bytes);
+    std::string name = std::string(f2d::borderName(border)) + "/" +
+                       preset.name + "/" + std::to_string(width) + "x" +
+                       std::to_string(height) + "/" + f2d::formatName(fmt);
+    int failed = 0;
+
+    auto check = [&](const char *what, const std::vector<uint8_t> &expect) {
+        (*checks)++;
+        if (memcmp(out.data(), expect.data(), bytes)) {
+            std::cout << "MISMATCH  " << what << " " << name << std::endl;
+            failed++;
+        }
+    };
+
+    syntheticFrame(width, height, src);
+    f2d::filterFrame(src.data(), whole.data(), width, height, fmt, taps,
+                     border);
+
+    naiveFilter(src.data(), out.data(), width, height, fmt, taps, border);
+    check("naive", whole);
+
+    // bands of 5 rows, bottom up
+    for (int r = (height - 1) / 5 * 5; r >= 0; r -= 5)
+        f2d::filterRows(src.data(), out.data(), width, height, fmt, taps, r,
+                        r + 5, border);
+    check("bands", whole);
+
+    std::vector<std::unique_ptr<f2d::CpuWorker>> pool;
+    std::vector<f2d::FilterWorker *> workers;
+    for (int i = 0; i < 3; i++) {
+        pool.emplace_back(new f2d::CpuWorker(taps, fmt, border));
+        workers.push_back(pool.back().get());
+    }
+    f2d::HeteroScheduler scheduler(workers, 2);
+    scheduler.run(src.data(), out.data(), width, height,
+                  f2d::RowBand{0, height});
+    check("scheduler", whole);
+
+    f2d::filterChain(src.data(), out.data(), width, height, fmt, taps, 1,
+                     border);
+    check("chain", whole);
+
+    std::vector<int16_t> chain(taps, taps + f2d::FILTER_TAPS);
+    chain.insert(chain.end(), second, second + f2d::FILTER_TAPS);
+    f2d::filterFrame(whole.data(), ref.data(), width, height, fmt, second,
+                     border);
+    f2d::filterChain(src.data(), out.data(), width, height, fmt, chain.data(),
+                     2, border);
+    check("chain2", ref);
+
+    // changed rows near the bottom, refreshed on the previous result
+    next = src;
+    for (size_t i = stride * (height * 3 / 4); i < bytes; i++)
+        next[i] ^= 0x5A;
+    f2d::DirtyRegionTracker tracker(height, stride, 4);
+    tracker.update(src.data());
+    out = whole;
+    for (const f2d::RowBand &band : tracker.update(next.data()))
+        f2d::filterRows(next.data(), out.data(), width, height, fmt, taps,
+                        band.begin, band.end, border);
+    f2d::filterFrame(next.data(), ref.data(), width, height, fmt, taps,
+                     border);
+    check("dirty", ref);
+
+    if (fmt != f2d::PixelFormat::YUYV)
+        return failed;
+    // three copies in an atlas of stale samples, two on the first shelf,
+    // the second one at the right edge, and one at the bottom edge
+    int atlasWidth = 2 * width + f2d::MOSAIC_GUARD_COLS;
+    int atlasHeight = 2 * height + f2d::MOSAIC_GUARD_ROWS;
+    std::vector<uint8_t> atlas, atlasOut((size_t)atlasWidth * atlasHeight * 2);
+    f2d::MosaicPacker packer(atlasWidth, atlasHeight);
+    f2d::MosaicSlot slots[3];
+    syntheticFrame(atlasWidth, atlasHeight, atlas);
+    for (f2d::MosaicSlot &slot : slots) {
+        packer.add(width, height, &slot);
+        f2d::mosaicPack(src.data(), atlas.data(), atlasWidth, atlasHeight,
+                        slot, border);
+    }
+    f2d::filterRows(atlas.data(), atlasOut.data(), atlasWidth, atlasHeight,
+                    fmt, taps, 0, packer.usedRows(), border);
+    for (const f2d::MosaicSlot &slot : slots) {
+        f2d::mosaicUnpack(atlasOut.data(), atlasWidth, slot, out.data());
+        check("mosaic", whole);
+    }
+    return failed;
+}
+
+/*
+ * Run verifyCase() for every border mode and filter, on small and single
+ * row frames in a packed and a planar format. A filter with large taps
+ * covers the scalar fallback of the SIMD path.
+ */
+int verifySplitters() {
+    static const int sizes[][2] = {{2, 1}, {18, 3}, {322, 37}};
+    static const f2d::FilterPreset wide = {
+        "Wide", {40, -60, 80, 100, 120, -140, 160, 180, 200}};
+    static const f2d::BorderMode borders[] = {f2d::BorderMode::CONSTANT,
+                                              f2d::BorderMode::REPLICATE,
+                                              f2d::BorderMode::REFLECT_101};
+    static const f2d::PixelFormat formats[] = {f2d::PixelFormat::YUYV,
+                                               f2d::PixelFormat::GRAY8};
+    std::vector<f2d::FilterPreset> filters(
+        f2d::filterPresets, f2d::filterPresets + f2d::filterPresetCount);
+    int checks = 0;
+    int failed = 0;
+
+    filters.push_back(f2d::aieEdgeFilter);
+    filters.push_back(wide);
+    for (f2d::BorderMode border : borders) {
+        for (const f2d::FilterPreset &preset : filters) {
+            for (const auto &size : sizes) {
+                for (f2d::PixelFormat fmt : formats)
+                    failed += verifyCase(preset, size[0], size[1], fmt,
+                                         border, &checks);
+            }
+        }
+    }
+    std::cout << "Verify: " << checks - failed << "/" << checks
+              << " split results bit-identical to whole frames" << std::endl;
+    return failed;
+}
+
+/*
+ * Largest per-byte difference of a conversion from expect, printed with
+ * name when above tolerance. Counts the check and returns 1 on failure.
+ */
+static int checkConversion(const std::string &name, const uint8_t *out,
+                           const uint8_t *expect, size_t bytes, int tolerance,
+                           int *checks) {
+    int worst = 0;
+
+    for (size_t i = 0; i < bytes; i++)
+        worst = std::max(worst, abs(out[i] - expect[i]));
+    (*checks)++;
+    if (worst <= tolerance)
+        return 0;
+    std::cout << "MISMATCH  " << name << " off by " << worst << std::endl;
+    return 1;
+}
+
+/*
+ * Check the format converters: pure colours against the BT.601 equations,
+ * exact round trips between the YUV layouts and GRAY8, and BGR round trips
+ * within 2. Frame sizes cover the SIMD blocks and their scalar tails.
+ */
+int verifyFormats() {
+    static const int sizes[][2] = {{2, 1}, {34, 6}, {640, 4}};
+    static const uint8_t colours[][3] = {{255, 255, 255}, {0, 0, 0},
+                                         {128, 128, 128}, {255, 0, 0},
+                                         {0, 255, 0},     {0, 0, 255},
+                                         {40, 200, 90}};
+    const f2d::PixelFormat BGR = f2d::PixelFormat::BGR;
+    const f2d::PixelFormat YUYV = f2d::PixelFormat::YUYV;
+    const f2d::PixelFormat NV12 = f2d::PixelFormat::NV12;
+    const f2d::PixelFormat NV16 = f2d::PixelFormat::NV16;
+    const f2d::PixelFormat GRAY8 = f2d::PixelFormat::GRAY8;
+    int checks = 0;
+    int failed = 0;
+
+    for (const auto &size : sizes) {
+        int width = size[0];
+        int height = size[1];
+        size_t pixels = (size_t)width * height;
+        std::string name = std::to_string(width) + "x" + std::to_string(height);
+        std::vector<uint8_t> yuyv, bgr(pixels * 3), back(pixels * 3);
+        std::vector<uint8_t> nv16(pixels * 2), nv12(pixels * 3 / 2);
+        std::vector<uint8_t> gray(pixels), out(pixels * 3);
+
+        // a flat colour gives the same pixel pairs, nothing to average
+        for (const uint8_t *c : colours) {
+            double b = c[0], g = c[1], r = c[2];
+            double y = 0.299 * r + 0.587 * g + 0.114 * b;
+            double u = 0.492 * (b - y) + 128;
+            double v = 0.877 * (r - y) + 128;
+            uint8_t pair[4] = {
+                (uint8_t)(y + 0.5),
+                (uint8_t)std::min(std::max(u + 0.5, 0.0), 255.0),
+                (uint8_t)(y + 0.5),
+                (uint8_t)std::min(std::max(v + 0.5, 0.0), 255.0)};
+            for (size_t i = 0; i < pixels; i++) {
+                memcpy(&bgr[i * 3], c, 3);
+                memcpy(&back[i * 2], pair + i % 2 * 2, 2);
+            }
+            f2d::convertFrame(bgr.data(), BGR, out.data(), YUYV, width,
+                              height);
+            failed += checkConversion(
+                "BGR->YUYV " + name + " colour " + std::to_string(c[0]) +
+                    "," + std::to_string(c[1]) + "," + std::to_string(c[2]),
+                out.data(), back.data(), pixels * 2, 1, &checks);
+        }
+
+        // unsaturated colours in equal pairs survive BGR -> YUV -> BGR
+        for (size_t i = 0; i < pixels * 3; i++)
+            bgr[i] = (uint8_t)(64 + (i / 6 * 37 + i % 3 * 53) % 129);
+        for (f2d::PixelFormat fmt : {YUYV, NV16}) {
+            f2d::convertFrame(bgr.data(), BGR, out.data(), fmt, width, height);
+            f2d::convertFrame(out.data(), fmt, back.data(), BGR, width,
+                              height);
+            failed += checkConversion(std::string("BGR round trip ") +
+                                          f2d::formatName(fmt) + " " + name,
+                                      back.data(), bgr.data(), pixels * 3, 2,
+                                      &checks);
+        }
+
+        // repacking between YUV layouts is exact
+        syntheticFrame(width, height, yuyv);
+        f2d::convertFrame(yuyv.data(), YUYV, nv16.data(), NV16, width, height);
+        f2d::convertFrame(nv16.data(), NV16, out.data(), YUYV, width, height);
+        failed += checkConversion("YUYV<->NV16 " + name, out.data(),
+                                  yuyv.data(), pixels * 2, 0, &checks);
+        if (height % 2 == 0) {
+            f2d::convertFrame(yuyv.data(), YUYV, nv12.data(), NV12, width,
+                              height);
+            failed += checkConversion("YUYV->NV12 luma " + name, nv12.data(),
+                                      nv16.data(), pixels, 0, &checks);
+            f2d::convertFrame(nv12.data(), NV12, out.data(), NV16, width,
+                              height);
+            f2d::convertFrame(out.data(), NV16, back.data(), NV12, width,
+                              height);
+            failed += checkConversion("NV12<->NV16 " + name, back.data(),
+                                      nv12.data(), pixels * 3 / 2, 0,
+                                      &checks);
+        }
+
+        // GRAY8 is the luma plane, and neutral chroma in BGR
+        f2d::convertFrame(yuyv.data(), YUYV, gray.data(), GRAY8, width,
+                          height);
+        failed += checkConversion("YUYV->GRAY8 " + name, gray.data(),
+                                  nv16.data(), pixels, 0, &checks);
+        f2d::convertFrame(gray.data(), GRAY8, out.data(), BGR, width, height);
+        for (size_t i = 0; i < pixels; i++)
+            memset(&back[i * 3], gray[i], 3);
+        failed += checkConversion("GRAY8->BGR " + name, out.data(),
+                                  back.data(), pixels * 3, 0, &checks);
+        f2d::convertFrame(out.data(), BGR, back.data(), GRAY8, width, height);
+        failed += checkConversion("GRAY8<->BGR " + name, back.data(),
+                                  gray.data(), pixels, 0, &checks);
+    }
+
+    // 2x1 frames take the scalar path, the SIMD blocks must match it bit
+    // for bit: every U, V pair with varying luma, and BGR spread widely
+    const int width = 512;
+    const int height = 256;
+    size_t pixels = (size_t)width * height;
+    std::vector<uint8_t> src(pixels * 3), whole(pixels * 3), pairs(pixels * 3);
+    for (size_t i = 0; i < pixels; i++) {
+        src[i * 2] = (uint8_t)(i * 7);
+        src[i * 2 + 1] = (uint8_t)(i % 2 ? i >> 9 : i >> 1);
+    }
+    f2d::convertFrame(src.data(), YUYV, whole.data(), BGR, width, height);
+    for (size_t i = 0; i < pixels; i += 2)
+        f2d::convertFrame(&src[i * 2], YUYV, &pairs[i * 3], BGR, 2, 1);
+    failed += checkConversion("YUYV->BGR SIMD", whole.data(), pairs.data(),
+                              pixels * 3, 0, &checks);
+    for (size_t i = 0; i < pixels; i++) {
+        src[i * 3] = (uint8_t)i;
+        src[i * 3 + 1] = (uint8_t)(i >> 8);
+        src[i * 3 + 2] = (uint8_t)(i * 13 + (i >> 16) * 101);
+    }
+    f2d::convertFrame(src.data(), BGR, whole.data(), YUYV, width, height);
+    for (size_t i = 0; i < pixels; i += 2)
+        f2d::convertFrame(&src[i * 3], BGR, &pairs[i * 2], YUYV, 2, 1);
+    failed += checkConversion("BGR->YUYV SIMD", whole.data(), pairs.data(),
+                              pixels * 2, 0, &checks);
+
+    std::cout << "Formats: " << checks - failed << "/" << checks
+              << " conversions within tolerance" << std::endl;
+    return failed;
+}
+
+/*
+ * Time the metrics updates the hosts make per frame: frame, byte and
+ * failure counters, kernel and frame time histograms and a pipeline queue
+ * round trip. Returns ns per frame.
+ */
+double metricsFrameNs() {
+    const int frames = 1000000;
+    f2d::HostMetrics &stats = f2d::hostMetrics();
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int n = 0; n < frames; n++) {
+        stats.pipelineQueue.add(1);
+        stats.frames.add();
+        stats.bytesToDevice.add(4147200);
+        stats.bytesFromDevice.add(4147200);
+        stats.kernelTime.observe(2000000 + n);
+        stats.frameTime.observe(3000000 + n);
+        stats.mismatchedBytes.add(0);
+        stats.pipelineQueue.add(-1);
+    }
+    std::chrono::duration<double, std::nano> dt =
+        std::chrono::steady_clock::now() - t0;
+    return dt.count() / frames;
+}
+
+/*
+ * Measure every filter (or only the named one) at every frame size, on the
+ * CPU alone and through the load balancing scheduler.
+ */
+std::vector<Result> measureAll(int frames, const std::string &only) {
+    std::vector<Result> results;
+
+    for (int f = 0; f <= f2d::filterPresetCount; f++) {
+        const f2d::FilterPreset &preset = f < f2d::filterPresetCount
+                                              ? f2d::filterPresets[f]
+                                              : f2d::aieEdgeFilter;
+        // each filter with the border of the engine it comes from
+        f2d::BorderMode border = f < f2d::filterPresetCount
+                                     ? f2d::BorderMode::CONSTANT
+                                     : f2d::BorderMode::REPLICATE;
+        if (!only.empty() && only != preset.name)
+            continue;
+        for (const auto &size : frameSizes) {
+            int width = size[0];
+            int height = size[1];
+            std::string suffix = std::string("/") + preset.name + "/" +
+                                 std::to_string(width) + "x" +
+                                 std::to_string(height);
+
+            // the CPU filter alone
+            results.push_back(
+                measure("cpu" + suffix, width, height, frames,
+                        [&](const uint8_t *src, uint8_t *dst) {
+                            f2d::filterFrame(src, dst, width, height,
+                                             f2d::PixelFormat::YUYV,
+                                             preset.taps, border);
+                        }));
+
+            // the load balanced path of the hosts, stand-in plus a CPU worker
+            int standInUs =
+                (int)(STAND_IN_CALIBRATIONS * calibrationUs(width, height));
+            f2d::StandInDevice standIn(preset.taps, standInUs,
+                                       f2d::PixelFormat::YUYV, border);
+            f2d::CpuWorker cpu(preset.taps, f2d::PixelFormat::YUYV, border);
+            f2d::HeteroScheduler scheduler({&standIn, &cpu});
+            results.push_back(
+                measure("stand-in" + suffix, width, height, frames,
+                        [&](const uint8_t *src, uint8_t *dst) {
+                            scheduler.run(src, dst, width, height,
+                                          f2d::RowBand{0, height});
+                        }));
+        }
+    }
+    return results;
+}
+
+/*
+ * Baselines hold one result object per line, as written by writeResults();
+ * reading picks the fields out of each line rather than parsing full JSON.
+ */
+static double field(const std::string &line, const std::string &key) {
+    size_t pos = line.find("\"" + key + "\":");
+    return pos == std::string::npos
+               ? -1
+               : strtod(line.c_str() + pos + key.size() + 3, nullptr);
+}
+
+bool readResults(const std::string &path, std::map<std::string, Result> &out) {
+    std::ifstream in(path.c_str());
+    std::string line;
+
+    if (!in)
+        return false;
+    while (std::getline(in, line)) {
+        size_t pos = line.find("\"name\": \"");
+        if (pos == std::string::npos)
+            continue;
+        pos += 9;
+        Result r;
+        r.name = line.substr(pos, line.find('"', pos) - pos);
+        r.fps = field(line, "fps");
+        r.relative = std::max(field(line, "relative"), 0.0);
+        r.p50Ms = field(line, "p50_ms");
+        r.p95Ms = field(line, "p95_ms");
+        r.p99Ms = field(line, "p99_ms");
+        r.checksum = (uint32_t)field(line, "checksum");
+        out[r.name] = r;
+    }
+    return true;
+}
+
+bool writeResults(const std::string &path, const std::vector<Result> &results) {
+    std::ofstream out(path.c_str(), std::ofstream::trunc);
+
+    out << "{\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result &r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"fps\": " << r.fps
+            << ", \"relative\": " << r.relative << ", \"p50_ms\": " << r.p50Ms
+            << ", \"p95_ms\": " << r.p95Ms << ", \"p99_ms\": " << r.p99Ms
+            << ", \"checksum\": " << r.checksum << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return (bool)out;
+}
+
+/*
+ * A result regresses when its throughput relative to the calibration loop
+ * drops by more than the tolerance, or when its output changed. Baselines
+ * without relative throughput compare absolute fps. Latency percentiles are
+ * reported but, with every sample counted, too noisy on shared machines to
+ * gate on.
+ */
+bool compareResult(const Result &r, const Result &base, double tolerance) {
+    bool relative = r.relative > 0 && base.relative > 0;
+    bool slower = relative ? r.relative < base.relative * (1 - tolerance)
+                           : r.fps < base.fps * (1 - tolerance);
+    bool changed = r.checksum != base.checksum;
+
+    std::cout << (changed ? "CHANGED   " : slower ? "REGRESSED " : "ok        ")
+              << r.name << ": " << r.fps << " fps x" << r.relative
+              << " (baseline " << base.fps << " fps x" << base.relative
+              << "), p50 " << r.p50Ms << "ms (baseline " << base.p50Ms
+              << "ms)" << std::endl;
+    return !slower && !changed;
+}
+
+int main(int argc, char **argv) {
+    std::string baseline, output, only;
+    double tolerance;
+    int frames;
+    int runs;
+    bool update;
+    bool verifyOnly;
+    int failed;
+
+    baseline = "baseline.json";
+    tolerance = 0.15;
+    frames = 10;
+    runs = 1;
+    update = false;
+    verifyOnly = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-b" && i + 1 < argc) {
+            baseline = argv[++i];
+        } else if (arg == "-o" && i + 1 < argc) {
+            output = argv[++i];
+        } else if (arg == "-t" && i + 1 < argc) {
+            tolerance = atof(argv[++i]);
+        } else if (arg == "-n" && i + 1 < argc) {
+            frames = std::max(atoi(argv[++i]), 1);
+        } else if (arg == "-r" && i + 1 < argc) {
+            runs = std::max(atoi(argv[++i]), 1);
+        } else if (arg == "-f" && i + 1 < argc) {
+            only = argv[++i];
+        } else if (arg == "-u") {
+            update = true;
+        } else if (arg == "-x") {
+            verifyOnly = true;
+        } else {
+            printHelp();
+            return arg == "-h" ? 0 : -1;
+        }
+    }
+
+    // a fast path that is no longer exact fails before it is timed
+    failed = verifySplitters() + verifyFormats();
+    double metricsNs = metricsFrameNs();
+    std::cout << "Metrics: " << metricsNs << "ns per frame (budget "
+              << METRICS_BUDGET_NS << "ns)" << std::endl;
+    if (metricsNs >= METRICS_BUDGET_NS)
+        failed++;
+    if (failed || verifyOnly)
+        return failed ? 1 : 0;
+
+    // with several runs each case keeps the run of median relative
+    // throughput, so a single lucky or disturbed run sets no baseline
+    std::vector<std::vector<Result>> all;
+    for (int run = 0; run < runs; run++)
+        all.push_back(measureAll(frames, only));
+    std::vector<Result> results = all[0];
+    for (size_t i = 0; i < results.size(); i++) {
+        std::vector<Result> cases;
+        for (const std::vector<Result> &run : all)
+            cases.push_back(run[i]);
+        std::nth_element(cases.begin(), cases.begin() + runs / 2, cases.end(),
+                         [](const Result &a, const Result &b) {
+                             return a.relative < b.relative;
+                         });
+        results[i] = cases[runs / 2];
+    }
+
+    if (!output.empty() && !writeResults(output, results)) {
+        std::cerr << "Failed to write " << output << std::endl;
+        return -1;
+    }
+    if (update) {
+        if (!writeResults(baseline, results)) {
+            std::cerr << "Failed to write " << baseline << std::endl;
+            return -1;
+        }
+        std::cout << "Baseline " << baseline << " updated with "
+                  << results.size() << " results" << std::endl;
+        return 0;
+    }
+
+    std::map<std::string, Result> base;
+    if (!readResults(baseline, base)) {
+        std::cerr << "Failed to read baseline " << baseline << std::endl;
+        return -1;
+    }
+    failed = 0;
+    for (const Result &r : results) {
+        auto it = base.find(r.name);
+        if (it == base.end())
+            std::cout << "new       " << r.name << ": " << r.fps << " fps"
+                      << std::endl;
+        else if (!compareResult(r, it->second, tolerance))
+            failed++;
+    }
+    if (failed) {
+        std::cout << "Result: " << failed << "/" << results.size()
+                  << " cases regressed beyond " << tolerance * 100 << "%"
+                  << std::endl;
+        return 1;
+    }
+    std::cout << "Result: no regressions" << std::endl;
+    return 0;
+}
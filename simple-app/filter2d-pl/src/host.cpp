@@ -15,64 +15,34 @@
  * under the License.
  */
 
-#include "xcl2.hpp"
-#include <CL/cl.h>
+#include "cpu_filter.hpp"
+#include "dirty_region.hpp"
+#include "filter_presets.hpp"
+#include "frame_io.hpp"
+#include "hetero_scheduler.hpp"
+#include "host_options.hpp"
+#include "host_pipeline.hpp"
+#include "metrics.hpp"
+#include "pixel_format.hpp"
+#include "pl_worker.hpp"
+#include "placement.hpp"
+#include "thumbnails.hpp"
 #include <iostream>
-#include <opencv2/core/core.hpp>
-#include <opencv2/highgui.hpp>
-#include <opencv2/imgcodecs.hpp>
-#include <opencv2/imgproc.hpp>
-#include <opencv2/opencv.hpp>
+#include <memory>
+#include <sstream>
 #include <stdint.h>
-#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <string>
-#include <sys/stat.h>
 
-// #define DEBUG_MODE 1 // uncomment to enable debug information
-#define FILTER_HEIGHT 3
-#define FILTER_WIDTH 3
 #define RESIZE_HEIGHT 1080
 #define RESIZE_WIDTH 1920
-#define FOURCC 0x56595559 // YUYV Format
-
-// opencv filter coefficients
-float cvkdata[][FILTER_HEIGHT][FILTER_WIDTH] = {
-    // opencv hgrad
-    {{-1, -1, -1}, {0, 0, 0}, {1, 1, 1}},
-    // opencv emboss
-    {{-2, -1, 0}, {-1, 1, 1}, {0, 1, 2}},
-    // opencv edge
-    {{0, 1, 0}, {1, -4, 1}, {0, 1, 0}},
-    // opencv blur
-    {{1, 1, 1}, {1, -7, 1}, {1, 1, 1}},
-    // opencv identity
-    {{0, 0, 0}, {0, 1, 0}, {0, 0, 0}},
-    // opencv hsobel
-    {{1, 2, 1}, {0, 0, 0}, {-1, -2, -1}}};
-
-void matrixDeconstructor(float matrix[][FILTER_WIDTH], short int Darray[]) {
-    int i;
-
-    i = 0;
-    for (int r = 0; r < FILTER_HEIGHT; r++) {
-        for (int c = 0; c < FILTER_WIDTH; c++) {
-            Darray[i++] = (short int)matrix[r][c];
-        }
-    }
-}
-
-const char *filterArgs[] = {
-    "Horizontal-Gradient", "Emboss", "Edge", "Blur", "Identity",
-    "Horizontal-Sobel"};
-
-enum Filter { HGRAD, EMBOSS, EDGE, BLUR, IDENTITY, HSOBEL, MAX_FILTER_NUM };
 
 void printFilterOptions(void) {
     std::cout << "Available Filter Options:\n"
               << "------------------------" << std::endl;
-    for (int i = 0; i < (int)MAX_FILTER_NUM; i++)
-        std::cout << filterArgs[i] << std::endl;
+    for (int i = 0; i < f2d::filterPresetCount; i++)
+        std::cout << f2d::filterPresets[i].name << std::endl;
 }
 
 void printHelp(void) {
@@ -82,87 +52,92 @@ void printHelp(void) {
         << "=================================================" << std::endl
         << "<Executable Name> <Filter> -i [input_image_path] -u [user_xclbin]"
         << std::endl
+        << f2d::hostOptionsHelp()
+        << "    -d [rows]        incremental mode, refresh only changed "
+           "stripes of rows"
+        << std::endl
+        << "    -c               filter on the CPU instead of the accelerator"
+        << std::endl
+        << "    -t [pattern]     benchmark per-image against mosaic "
+           "batched launches"
+        << std::endl
+        << "                     on the small images matching pattern"
+        << std::endl
+        << "    -b [threads]     share frames between the accelerator and "
+           "CPU worker threads"
+        << std::endl
+        << "    -s [usec]        with -b, replace the accelerator by a "
+           "stand-in of given latency"
+        << std::endl
+        << "    --chain [F1,F2]  in place of <Filter>, apply the filters in "
+           "turn in one pass"
+        << std::endl
+        << "    --numa-bench     measure frame transfer bandwidth from "
+           "every NUMA node"
+        << std::endl
+        << "    --border [mode]  constant (default), replicate or "
+           "reflect-101, other than"
+        << std::endl
+        << "                     constant on the CPU only (-c or -s)"
+        << std::endl
         << std::endl
         << "Example: filter2D_accel_pl.elf Emboss" << std::endl
+        << "Example: filter2D_accel_pl.elf --chain Blur,Edge" << std::endl
+        << "Example: filter2D_accel_pl.elf Edge -v cam.mp4 -d 16" << std::endl
+        << "Example: filter2D_accel_pl.elf Blur -p NV12" << std::endl
+        << "Example: filter2D_accel_pl.elf Edge -c --border replicate"
+        << std::endl
         << std::endl;
     printFilterOptions();
 }
 
-enum Filter getCoeffString(std::string argv) {
-    for (int i = 0; i < (int)MAX_FILTER_NUM; i++) {
-        if (strcmp(filterArgs[i], argv.c_str()) == 0)
-            return ((enum Filter)i);
-    }
+// Work the incremental mode saved: bytes moved to and from the device when
+// the accelerator filters, rows filtered when the CPU does all the work
+void printDirtyStats(const f2d::DirtyStats &st, bool device) {
+    if (device)
+        std::cout << "moved " << st.movedBytes << "/" << st.fullBytes
+                  << " Bytes, saved " << st.savedBytes() << " Bytes";
+    else
+        std::cout << "filtered " << st.filteredRows << "/" << st.fullRows
+                  << " rows";
+}
+
+const f2d::FilterPreset &getCoeffString(std::string argv) {
+    const f2d::FilterPreset *preset = f2d::findFilterPreset(argv);
+    if (preset)
+        return *preset;
     std::cerr << "Invalid Filter Type Usage: see below options \n";
     printFilterOptions();
     exit(EXIT_FAILURE);
 }
 
-void cvtColorRGB2YUY2(cv::Mat &src, cv::Mat &dst) {
-    cv::Mat temp;
-    cv::cvtColor(src, temp, cv::COLOR_BGR2YUV);
-    std::vector<uint8_t> v1;
-    for (int i = 0; i < src.rows; i++) {
-        for (int j = 0; j < src.cols; j++) {
-            v1.push_back(temp.at<cv::Vec3b>(i, j)[0]);
-            j % 2 ? v1.push_back(temp.at<cv::Vec3b>(i, j)[2])
-                  : v1.push_back(temp.at<cv::Vec3b>(i, j)[1]);
-        }
-    }
-    cv::Mat yuy2(src.rows, src.cols, CV_8UC2);
-    memcpy(yuy2.data, v1.data(), src.cols * src.rows * 2);
-    dst = yuy2;
-}
-
-void compareResuts(cv::Mat &outImg, cv::Mat &ref, int rows, int cols) {
-    int acceptableError;
-    int errCount;
-    uint8_t *dataOut;
-    uint8_t *dataRefOut;
-
-    std::vector<uint8_t> hwDataVec;
-    std::vector<uint8_t> cvDataVec;
-    hwDataVec.assign(outImg.data, (outImg.data + outImg.total()));
-    cvDataVec.assign(ref.data, (ref.data + ref.total()));
-    acceptableError = 1;
-    errCount = 0;
-    dataOut = (uint8_t *)hwDataVec.data();
-    dataRefOut = (uint8_t *)cvDataVec.data();
-    for (int i = 0; i < cols * rows; i++) {
-        if (abs(dataRefOut[i] - dataOut[i]) > acceptableError) {
-#ifdef DEBUG_MODE
-            std::cout << "err at : i=" << i
-                      << " err=" << abs(dataRefOut[i] - dataOut[i]) << "="
-                      << unsigned(dataRefOut[i]) << "-" << unsigned(dataOut[i])
-                      << std::endl;
-#endif
-            errCount++;
-        }
-    }
-    if (errCount) {
-        std::cout << "Result: Test failed " << errCount << "/" << cols * rows
-                  << " unmatched Bytes" << std::endl;
-    } else
-        std::cout << "Result: Test Passed" << std::endl;
-}
-
 int main(int argc, char **argv) {
-    enum Filter Ftype;
-    short int Darray[9] = {0};
+    std::vector<const f2d::FilterPreset *> chain;
+    std::vector<int16_t> chainTaps;
     int height;
     int width;
-    int chan;
-    cl_int err;
-    cl_ulong start;
-    cl_ulong end;
+    int rowBytes;
+    int stripeRows;
+    int frameNum;
+    int balanceThreads;
+    int standInUs;
+    size_t bytes;
+    bool useCpu;
+    bool useAccel;
+    bool numaBench;
     double diffProf;
 
-    std::string arg, inputImage, userXclbin;
-    inputImage = "/opt/xilinx/testimg/HD.jpg";
-    userXclbin = "/opt/xilinx/firmware/emb_plus/ve2302_pcie_qdma/base/test/"
-                 "filter2d_pl.xclbin";
-
-    if (argc < 2 || argc > 6) {
+    std::string arg, chainArg, thumbnails;
+    f2d::BorderMode border = f2d::BorderMode::CONSTANT;
+    f2d::HostOptions opts("/opt/xilinx/firmware/emb_plus/ve2302_pcie_qdma/"
+                          "base/test/filter2d_pl.xclbin");
+    stripeRows = 0;
+    balanceThreads = 0;
+    standInUs = -1;
+    useCpu = false;
+    numaBench = false;
+
+    if (argc < 2 || argc > 30) {
         std::cerr << "Invalid number for arguments passed" << std::endl;
         printHelp();
         return -1;
@@ -175,153 +150,247 @@ int main(int argc, char **argv) {
         return 0;
     }
 
-    for (int i = 2; i < argc; ++i) {
-        if (std::string(argv[i]) == "-i" && i + 1 < argc) {
-            inputImage = argv[i + 1];
-        } else if (std::string(argv[i]) == "-u" && i + 1 < argc) {
-            userXclbin = argv[i + 1];
+    for (int i = 1; i < argc; ++i) {
+        int used = i > 1 ? f2d::parseHostOption(argc, argv, i, opts) : 0;
+        if (used < 0) {
+            std::cerr << "Invalid value for " << argv[i] << std::endl;
+            return -1;
+        } else if (used > 0) {
+            i += used - 1;
+        } else if (std::string(argv[i]) == "--chain" && i + 1 < argc) {
+            chainArg = argv[i + 1];
+        } else if (i == 1) {
+            continue; // <Filter>
+        } else if (std::string(argv[i]) == "-d" && i + 1 < argc) {
+            stripeRows = atoi(argv[i + 1]);
+        } else if (std::string(argv[i]) == "-t" && i + 1 < argc) {
+            thumbnails = argv[i + 1];
+        } else if (std::string(argv[i]) == "-b" && i + 1 < argc) {
+            balanceThreads = atoi(argv[i + 1]);
+        } else if (std::string(argv[i]) == "-s" && i + 1 < argc) {
+            standInUs = atoi(argv[i + 1]);
+        } else if (std::string(argv[i]) == "-c") {
+            useCpu = true;
+        } else if (std::string(argv[i]) == "--numa-bench") {
+            numaBench = true;
+        } else if (std::string(argv[i]) == "--border" && i + 1 < argc) {
+            if (!f2d::parseBorder(argv[i + 1], &border)) {
+                std::cerr << "Invalid border mode " << argv[i + 1]
+                          << std::endl;
+                return -1;
+            }
+        }
+    }
+
+    if (chainArg.empty()) {
+        chain.push_back(&getCoeffString(arg));
+    } else {
+        std::stringstream stages(chainArg);
+        std::string stage;
+        if (arg != "--chain") {
+            std::cerr << "Pass either <Filter> or --chain" << std::endl;
+            return -1;
         }
+        while (std::getline(stages, stage, ','))
+            chain.push_back(&getCoeffString(stage));
+    }
+    if (chain.size() > 1 &&
+        (stripeRows > 0 || balanceThreads > 0 || !thumbnails.empty())) {
+        std::cerr << "--chain can not be combined with -d, -b or -t"
+                  << std::endl;
+        return -1;
+    }
+    f2d::PlacementPolicy placement;
+    if (!placement.parse(opts.coreSets)) {
+        std::cerr << "Invalid core sets " << opts.coreSets << std::endl;
+        return -1;
+    }
+    if (opts.format != f2d::PixelFormat::YUYV && !thumbnails.empty()) {
+        std::cerr << "-t only supports the YUYV format" << std::endl;
+        return -1;
     }
+    for (const f2d::FilterPreset *preset : chain)
+        chainTaps.insert(chainTaps.end(), preset->taps, preset->taps + 9);
+    const int16_t *taps = chain[0]->taps;
 
-    Ftype = getCoeffString(arg);
+    std::unique_ptr<f2d::MetricsFileExporter> exporter;
+    if (!opts.metricsFile.empty())
+        exporter.reset(new f2d::MetricsFileExporter(f2d::metrics(),
+                                                    opts.metricsFile));
 
     ////////////////////////// CV START /////////////////////////////////////
-    cv::Mat InImage, outImg, ref, resizedImg, temp, hwinImg;
-
-    // read Input image & resize to HD (jpg)
-    InImage = cv::imread(inputImage, cv::IMREAD_COLOR);
-    if (InImage.data == NULL) {
-        std::cerr << "Failed to open image at PATH: " << inputImage
+    std::string inputPath =
+        opts.inputVideo.empty() ? opts.inputImage : opts.inputVideo;
+    f2d::FrameSource source(inputPath, !opts.inputVideo.empty());
+    if (!source.isOpened()) {
+        std::cerr << "Failed to open image at PATH: " << inputPath
                   << std::endl;
         return (-1);
-    } else
-        std::cout << "Input Image: height:" << InImage.rows
-                  << ", width:" << InImage.cols
-                  << ", channels:" << InImage.channels()
-                  << ", pixels:" << InImage.total()
-                  << ", bytes:" << InImage.total() * InImage.elemSize()
-                  << ", Input image path:" << inputImage << std::endl;
-
-    std::cout << "Resizing input image from " << InImage.rows << "x"
-              << InImage.cols << " to " << RESIZE_WIDTH << "x" << RESIZE_HEIGHT
-              << std::endl;
-    cv::resize(InImage, resizedImg, cv::Size(RESIZE_WIDTH, RESIZE_HEIGHT), 0, 0,
-               cv::INTER_LINEAR);
-
-    // convert jpg image to yuv format (hwinput)
-    cvtColorRGB2YUY2(resizedImg, temp);
-    temp.convertTo(hwinImg, CV_8UC2);
-
-    // dump yuv and jpg (hwinImg)
-    cv::cvtColor(hwinImg, temp, cv::COLOR_YUV2BGR_YUYV);
-    imwrite("hwin_HD.jpg", temp);
+    }
+    std::cout << "Input: " << inputPath << ", resizing frames to "
+              << RESIZE_WIDTH << "x" << RESIZE_HEIGHT << ", format "
+              << f2d::formatName(opts.format) << std::endl;
 
-    // creating ocv ref image
-    cv::Mat filter(3, 3, CV_32F, cvkdata[(int)Ftype]);
-    cv::Point anchor = cv::Point(-1, -1);
-    std::vector<cv::Mat> yuvChannels, concatImg;
-    cv::split(hwinImg, yuvChannels);
-    cv::filter2D(yuvChannels[0], temp, CV_8U, filter, anchor, 0,
-                 cv::BORDER_CONSTANT);
-    concatImg.push_back(temp);           // Y channel
-    concatImg.push_back(yuvChannels[1]); // UV channel
-    cv::merge(concatImg, ref);
-    cv::cvtColor(ref, temp, cv::COLOR_YUV2BGR_YUYV);
-    imwrite("ocv_ref.jpg", temp); // CV reference image
+    height = RESIZE_HEIGHT;
+    width = RESIZE_WIDTH;
+    rowBytes = width * f2d::lumaStep(opts.format); // of the samples filtered
+    bytes = f2d::frameBytes(opts.format, width, height);
 
     ////////////////////////// CL START /////////////////////////////////////
-    height = hwinImg.rows;
-    width = hwinImg.cols;
-    chan = hwinImg.channels();
-    outImg.create(height, width, CV_8UC(chan));
-
-    // Find the versal device
-    std::cout << "create device object" << std::endl;
-    std::vector<cl::Device> devices = xcl::get_xil_devices();
-    cl::Device device = devices[0];
-    cl::Context context(device);
-
-    // create the command queue
-    cl::CommandQueue q(context, device, CL_QUEUE_PROFILING_ENABLE, &err);
-    std::cout << "create command queue " << err << std::endl;
-
-    // Program Kernel
-    std::cout << "Programming kernel" << std::endl;
-    std::string device_name = device.getInfo<CL_DEVICE_NAME>();
-    auto binaryFile = xcl::read_binary_file(userXclbin);
-    cl::Program::Binaries bins{{binaryFile.data(), binaryFile.size()}};
-    devices.resize(1);
-    cl::Program program(context, devices, bins);
-    cl::Kernel krnl(program, "filter2d_pl_accel", &err);
-    if (err) {
-        std::cerr << "Failed to program kernel" << std::endl;
-        return (-1);
+    PlWorker accel;
+    useAccel = !useCpu && !(balanceThreads > 0 && standInUs >= 0);
+    if (useAccel && border != accel.border()) {
+        std::cerr << "The accelerator only supports the "
+                  << f2d::borderName(accel.border())
+                  << " border, filter on the CPU with -c or -s" << std::endl;
+        return -1;
+    }
+    if (!useAccel) {
+        std::cout << "Filtering on the CPU, accelerator not used" << std::endl;
+    } else {
+        if (!accel.init(opts.userXclbin, width, height, opts.format, taps))
+            return (-1);
+        if (opts.numaNode < 0)
+            opts.numaNode = f2d::pciNumaNode(accel.bdf());
     }
-    // Allocate Buffer in Global Memory
-    std::cout << "Allocate buffer in global memory" << std::endl;
-    cl::Buffer imageToDevice(context, CL_MEM_READ_ONLY, (height * width * chan),
-                             NULL, &err);
-    std::cout << "create image to device buffer status:  " << err << std::endl;
-    cl::Buffer imageFromDevice(context, CL_MEM_WRITE_ONLY,
-                               (height * width * chan), NULL, &err);
-    std::cout << "create image from device status:       " << err << std::endl;
-    cl::Buffer kernelFilterToDevice(context, CL_MEM_READ_ONLY,
-                                    sizeof(short int) * 9, NULL, &err);
-    std::cout << "create kernel filter to device status: " << err << std::endl;
-
-    // Copying input data to Device buffer from host memory
-    std::cout << "1. Copying input data to device buffer"
-              << height * width * chan << " Bytes" << std::endl;
 
-    q.enqueueWriteBuffer(imageToDevice, CL_TRUE, 0, (height * width * chan),
-                         (unsigned short *)hwinImg.data);
-    std::cout << "2. Copying kernel data to device buffer" << std::endl;
+    // Keep frame buffers and the threads touching them on the node of the
+    // card, every pipeline stage on the cores of its role
+    placement.setNode(opts.numaNode);
+    placement.print(std::cout);
+    if (numaBench) {
+        f2d::runPlacementBench(placement, useAccel ? &accel : nullptr,
+                               height * rowBytes, std::cout);
+        return 0;
+    }
 
-    matrixDeconstructor(cvkdata[(int)Ftype], Darray);
-    q.enqueueWriteBuffer(kernelFilterToDevice, CL_TRUE, 0,
-                         sizeof(short int) * 9, (short int *)Darray);
-    std::cout << "set kernel arguments" << std::endl;
+    if (!thumbnails.empty()) {
+        // the CPU, or the stand-in of -s, whenever the accelerator is unused
+        std::unique_ptr<f2d::CpuWorker> cpu;
+        f2d::FilterWorker *filterer = &accel;
+        if (!useAccel && standInUs >= 0)
+            cpu.reset(new f2d::StandInDevice(taps, standInUs,
+                                             f2d::PixelFormat::YUYV, border));
+        else if (!useAccel)
+            cpu.reset(new f2d::CpuWorker(taps, f2d::PixelFormat::YUYV, border));
+        if (cpu)
+            filterer = cpu.get();
+        return f2d::runThumbnails(thumbnails, *filterer, chainTaps,
+                                  RESIZE_WIDTH, RESIZE_HEIGHT);
+    }
 
-    // Set the kernel arguments
-    krnl.setArg(0, imageToDevice);
-    krnl.setArg(1, imageFromDevice);
-    krnl.setArg(2, kernelFilterToDevice);
-    krnl.setArg(3, height);
-    krnl.setArg(4, width);
-    krnl.setArg(5, FOURCC); // fourcc in
-    krnl.setArg(6, FOURCC); // fourcc out
+    // With -b the accelerator (or its stand-in) and the CPU workers share
+    // every frame in proportion to their measured throughput
+    std::vector<std::unique_ptr<f2d::FilterWorker>> pool;
+    std::vector<f2d::FilterWorker *> workers;
+    std::unique_ptr<f2d::HeteroScheduler> scheduler;
+    if (balanceThreads > 0) {
+        if (standInUs >= 0)
+            pool.emplace_back(new f2d::StandInDevice(taps, standInUs,
+                                                     opts.format, border));
+        else if (!useCpu)
+            workers.push_back(&accel);
+        for (int i = 0; i < balanceThreads; i++)
+            pool.emplace_back(new f2d::CpuWorker(taps, opts.format, border));
+        for (auto &w : pool)
+            workers.push_back(w.get());
+        scheduler.reset(new f2d::HeteroScheduler(workers));
+        for (size_t i = 0; i < workers.size(); i++)
+            placement.pin(workers[i] == &accel ? f2d::ThreadRole::SUBMIT
+                                               : f2d::ThreadRole::CONVERT,
+                          scheduler->workerThread(i));
+    }
 
-    // Profiling Objects
-    start = 0;
-    end = 0;
-    diffProf = 0.0f;
-    cl::Event eventSp;
+    // in incremental mode output rows of unchanged stripes are reused from
+    // the previous frame, kept here across slots
+    std::unique_ptr<f2d::NodeBuffer> lastOut;
+    if (stripeRows > 0)
+        lastOut.reset(new f2d::NodeBuffer(bytes, opts.numaNode));
+    f2d::DirtyRegionTracker tracker(height, rowBytes, stripeRows);
+    std::vector<size_t> slotBands(opts.queueDepth);
+    std::vector<f2d::DirtyStats> slotDirty(opts.queueDepth);
+
+    // decode -> convert -> filter -> validate, with up to queueDepth frames
+    // in flight
+    f2d::HostPipeline pipeline(source, placement, opts.format, width, height,
+                               opts.queueDepth);
+    pipeline.setReference(chainTaps.data(), chain.size(), border);
+    pipeline.setFilter("filter", [&](size_t s, const uint8_t *in,
+                                     uint8_t *dst) {
+        uint8_t *out = lastOut ? lastOut->data() : dst;
+        std::vector<f2d::RowBand> bands;
+
+        if (stripeRows > 0)
+            bands = tracker.update(in);
+        else
+            bands.assign(1, f2d::RowBand{0, height});
+
+        if (chain.size() > 1) {
+            if (useCpu)
+                f2d::filterChain(in, out, width, height, opts.format,
+                                 chainTaps.data(), chain.size(), border);
+            else
+                accel.filterChain(in, out, width, height, chainTaps);
+            bands.clear();
+        }
+        for (const f2d::RowBand &band : bands) {
+            if (scheduler)
+                scheduler->run(in, out, width, height, band);
+            else if (useCpu)
+                f2d::filterRows(in, out, width, height, opts.format, taps,
+                                band.begin, band.end, border);
+            else
+                accel.filterBand(in, out, width, height, band);
+        }
+        f2d::copyChroma(in, out, opts.format, width, height);
+        if (lastOut)
+            memcpy(dst, out, bytes);
+        slotBands[s] = bands.size();
+        slotDirty[s] = tracker.lastFrameStats();
+    });
+    if (stripeRows > 0)
+        pipeline.setReport([&](size_t s, int index) {
+            std::cout << "Frame " << index << ": " << slotBands[s]
+                      << " dirty bands, ";
+            printDirtyStats(slotDirty[s], useAccel);
+            std::cout << std::endl;
+        });
 
-    // Launch the kernel
     std::cout << "launch the kernel" << std::endl;
-    q.enqueueTask(krnl, NULL, &eventSp);
-    clWaitForEvents(1, (const cl_event *)&eventSp);
+    frameNum = pipeline.run();
+    if (frameNum == 0) {
+        std::cerr << "Failed to read a frame from " << inputPath << std::endl;
+        return (-1);
+    }
+    diffProf = accel.kernelNs;
 
     // Profiling
     std::cout << "profiling" << std::endl;
-    eventSp.getProfilingInfo(CL_PROFILING_COMMAND_START, &start);
-    eventSp.getProfilingInfo(CL_PROFILING_COMMAND_END, &end);
-    diffProf = end - start;
-    std::cout << (diffProf / 1000000) << "ms" << std::endl;
-
-    // Copying Device result data to Host memory
-    std::cout << "Copying results" << std::endl;
-    q.enqueueReadBuffer(imageFromDevice, CL_TRUE, 0, (height * width * chan),
-                        (unsigned short *)outImg.data);
-    q.finish();
+    std::cout << (diffProf / 1000000 / frameNum) << "ms per frame"
+              << std::endl;
+    pipeline.printStats(std::cout);
+    if (scheduler)
+        scheduler->printStats(std::cout);
+    if (stripeRows > 0) {
+        const f2d::DirtyStats &st = tracker.stats();
+        std::cout << "Incremental: " << st.frames << " frames, "
+                  << st.skippedFrames << " unchanged, ";
+        printDirtyStats(st, useAccel);
+        std::cout << " ("
+                  << (useAccel ? 100.0 * st.savedBytes() / st.fullBytes
+                               : 100.0 * (st.fullRows - st.filteredRows) /
+                                     st.fullRows)
+                  << "% saved)" << std::endl;
+    }
 
-    std::cout << "Out Image: height:" << outImg.rows
-              << ", width:" << outImg.cols << ", channels:" << outImg.channels()
-              << ", pixels:" << outImg.total()
-              << ", bytes:" << outImg.total() * outImg.elemSize() << std::endl;
+    std::cout << "Out Image: height:" << height << ", width:" << width
+              << ", format:" << f2d::formatName(opts.format)
+              << ", bytes:" << bytes << std::endl;
 
-    cv::cvtColor(outImg, temp, cv::COLOR_YUV2BGR_YUYV);
-    imwrite("hw_out.jpg", temp); // reference image
-    compareResuts(outImg, ref, hwinImg.rows, hwinImg.cols);
+    // dump the last frame: yuv input, CV reference and hw output as jpg
+    pipeline.dumpLast("hwin_HD.jpg", "ocv_ref.jpg", "hw_out.jpg");
+    if (frameNum > 1)
+        std::cout << "Result: " << pipeline.failedFrames() << "/" << frameNum
+                  << " frames failed" << std::endl;
     return (0);
 }
@@ -0,0 +1,180 @@
+/**
+ * Copyright (C) 2019-2022 Xilinx, Inc
+ * Copyright (C) 2022-2024 Advance Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "pl_worker.hpp"
+#include "cpu_filter.hpp"
+#include "metrics.hpp"
+#include <CL/cl.h>
+#include <algorithm>
+#include <iostream>
+
+PlWorker::PlWorker()
+    : kernelNs(0), mFormat(f2d::PixelFormat::YUYV), mMaxPixels(0) {}
+
+// Frames larger than the device buffers would be read and written past
+// their end by the kernel
+static bool fitsBuffers(int width, int height, size_t maxPixels) {
+    if ((size_t)width * height <= maxPixels)
+        return true;
+    std::cerr << "Frame of " << width << "x" << height
+              << " exceeds the device buffers, not filtered" << std::endl;
+    return false;
+}
+
+bool PlWorker::init(const std::string &xclbin, int width, int height,
+                    f2d::PixelFormat fmt, const int16_t taps[9]) {
+    size_t frameBytes = (size_t)width * height * f2d::lumaStep(fmt);
+    char bdf[20] = "";
+    cl_int err;
+
+    mFormat = fmt;
+    mMaxPixels = (size_t)width * height;
+    std::copy(taps, taps + 9, mTaps);
+
+    // Find the versal device
+    std::cout << "create device object" << std::endl;
+    std::vector<cl::Device> devices = xcl::get_xil_devices();
+    cl::Device device = devices[0];
+    mContext = cl::Context(device);
+    device.getInfo(CL_DEVICE_PCIE_BDF, &bdf);
+    mBdf = bdf;
+
+    // create the command queue
+    mQ = cl::CommandQueue(mContext, device, CL_QUEUE_PROFILING_ENABLE, &err);
+    std::cout << "create command queue " << err << std::endl;
+
+    // Program Kernel
+    std::cout << "Programming kernel" << std::endl;
+    auto binaryFile = xcl::read_binary_file(xclbin);
+    cl::Program::Binaries bins{{binaryFile.data(), binaryFile.size()}};
+    devices.resize(1);
+    cl::Program program(mContext, devices, bins);
+    mKrnl = cl::Kernel(program, "filter2d_pl_accel", &err);
+    if (err) {
+        std::cerr << "Failed to program kernel" << std::endl;
+        return false;
+    }
+    // Allocate Buffer in Global Memory
+    std::cout << "Allocate buffer in global memory" << std::endl;
+    mImageToDevice =
+        cl::Buffer(mContext, CL_MEM_READ_WRITE, frameBytes, NULL, &err);
+    std::cout << "create image to device buffer status:  " << err
+              << std::endl;
+    mImageFromDevice =
+        cl::Buffer(mContext, CL_MEM_READ_WRITE, frameBytes, NULL, &err);
+    std::cout << "create image from device status:       " << err
+              << std::endl;
+    mKernelFilterToDevice = cl::Buffer(mContext, CL_MEM_READ_ONLY,
+                                       sizeof(short int) * 9, NULL, &err);
+    std::cout << "create kernel filter to device status: " << err
+              << std::endl;
+    f2d::hostMetrics().deviceBufferBytes.set(2 * frameBytes);
+
+    std::cout << "Copying kernel data to device buffer" << std::endl;
+    mQ.enqueueWriteBuffer(mKernelFilterToDevice, CL_TRUE, 0,
+                          sizeof(short int) * 9, mTaps);
+    std::cout << "set kernel arguments" << std::endl;
+
+    // Set the kernel arguments, the height is set per launch; planar
+    // formats reach the kernel as their Y plane
+    uint32_t fourcc = f2d::formatFourcc(
+        f2d::isPlanarLuma(fmt) ? f2d::PixelFormat::GRAY8 : fmt);
+    mKrnl.setArg(0, mImageToDevice);
+    mKrnl.setArg(1, mImageFromDevice);
+    mKrnl.setArg(2, mKernelFilterToDevice);
+    mKrnl.setArg(3, height);
+    mKrnl.setArg(4, width);
+    mKrnl.setArg(5, fourcc); // fourcc in
+    mKrnl.setArg(6, fourcc); // fourcc out
+    return true;
+}
+
+void PlWorker::filterBand(const uint8_t *src, uint8_t *dst, int width,
+                          int height, f2d::RowBand band) {
+    cl_ulong start = 0;
+    cl_ulong end = 0;
+    cl::Event eventSp;
+    size_t rowBytes = (size_t)width * f2d::lumaStep(mFormat);
+    f2d::RowBand in = {std::max(band.begin - f2d::FILTER_HALO, 0),
+                       std::min(band.end + f2d::FILTER_HALO, height)};
+
+    if (!fitsBuffers(width, height, mMaxPixels))
+        return;
+
+    mQ.enqueueWriteBuffer(mImageToDevice, CL_TRUE, 0, in.rows() * rowBytes,
+                          src + in.begin * rowBytes);
+    mKrnl.setArg(3, in.rows());
+    mKrnl.setArg(4, width);
+    mQ.enqueueTask(mKrnl, NULL, &eventSp);
+    clWaitForEvents(1, (const cl_event *)&eventSp);
+    eventSp.getProfilingInfo(CL_PROFILING_COMMAND_START, &start);
+    eventSp.getProfilingInfo(CL_PROFILING_COMMAND_END, &end);
+    mQ.enqueueReadBuffer(mImageFromDevice, CL_TRUE,
+                         (band.begin - in.begin) * rowBytes,
+                         band.rows() * rowBytes, dst + band.begin * rowBytes);
+    kernelNs += end - start;
+    f2d::hostMetrics().kernelTime.observe(end - start);
+    f2d::hostMetrics().bytesToDevice.add(in.rows() * rowBytes);
+    f2d::hostMetrics().bytesFromDevice.add(band.rows() * rowBytes);
+}
+
+void PlWorker::filterChain(const uint8_t *src, uint8_t *dst, int width,
+                           int height, const std::vector<int16_t> &taps) {
+    size_t bytes = (size_t)width * height * f2d::lumaStep(mFormat);
+    int stages = taps.size() / 9;
+    cl::Buffer *images[2] = {&mImageToDevice, &mImageFromDevice};
+    std::vector<cl::Event> events(stages);
+    cl_ulong start = 0;
+    cl_ulong end = 0;
+
+    if (!fitsBuffers(width, height, mMaxPixels))
+        return;
+    mQ.enqueueWriteBuffer(mImageToDevice, CL_FALSE, 0, bytes, src);
+    mKrnl.setArg(3, height);
+    mKrnl.setArg(4, width);
+    for (int k = 0; k < stages; k++) {
+        mQ.enqueueWriteBuffer(mKernelFilterToDevice, CL_FALSE, 0,
+                              sizeof(short int) * 9, &taps[k * 9]);
+        mKrnl.setArg(0, *images[k % 2]);
+        mKrnl.setArg(1, *images[(k + 1) % 2]);
+        mQ.enqueueTask(mKrnl, NULL, &events[k]);
+    }
+    mQ.enqueueReadBuffer(*images[stages % 2], CL_TRUE, 0, bytes, dst);
+
+    for (cl::Event &event : events) {
+        event.getProfilingInfo(CL_PROFILING_COMMAND_START, &start);
+        event.getProfilingInfo(CL_PROFILING_COMMAND_END, &end);
+        kernelNs += end - start;
+        f2d::hostMetrics().kernelTime.observe(end - start);
+    }
+    f2d::hostMetrics().bytesToDevice.add(bytes);
+    f2d::hostMetrics().bytesFromDevice.add(bytes);
+
+    // restore the bindings and coefficients filterBand() relies on
+    mKrnl.setArg(0, mImageToDevice);
+    mKrnl.setArg(1, mImageFromDevice);
+    mQ.enqueueWriteBuffer(mKernelFilterToDevice, CL_TRUE, 0,
+                          sizeof(short int) * 9, mTaps);
+}
+
+void PlWorker::upload(const uint8_t *src, size_t bytes) {
+    mQ.enqueueWriteBuffer(mImageToDevice, CL_TRUE, 0, bytes, src);
+}
+
+void PlWorker::download(uint8_t *dst, size_t bytes) {
+    mQ.enqueueReadBuffer(mImageFromDevice, CL_TRUE, 0, bytes, dst);
+}
@@ -0,0 +1,77 @@
+/**
+ * Copyright (C) 2019-2022 Xilinx, Inc
+ * Copyright (C) 2022-2024 Advance Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include "hetero_scheduler.hpp"
+#include "pixel_format.hpp"
+#include "placement.hpp"
+#include "xcl2.hpp"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// The filter2d_pl_accel kernel as a device backend. A band of output rows is
+// produced by uploading the band plus its filter halo, launching the kernel
+// on that region only and reading back the band. The border the kernel
+// applies at the region edges only reaches halo rows, which are dropped.
+// For the planar formats only the Y plane is moved, the kernel sees it as
+// a Y800 frame and the chroma plane stays on the host.
+class PlWorker : public f2d::FilterWorker, public f2d::FrameTransfer {
+  public:
+    PlWorker();
+
+    // Program the xclbin on the first device and allocate the buffers for
+    // frames of up to width x height, returns false on failure. Larger
+    // frames are rejected by filterBand() and filterChain().
+    bool init(const std::string &xclbin, int width, int height,
+              f2d::PixelFormat fmt, const int16_t taps[9]);
+
+    const char *name() const override { return "filter2d_pl_accel"; }
+    // the kernel reads zero past the frame edge
+    f2d::BorderMode border() const override {
+        return f2d::BorderMode::CONSTANT;
+    }
+    void filterBand(const uint8_t *src, uint8_t *dst, int width, int height,
+                    f2d::RowBand band) override;
+
+    // Run a chain of filters (9 taps per stage) without host round-trips:
+    // the two image buffers alternate as input and output, the coefficients
+    // are rewritten before each launch and only the result is read back.
+    // The in-order queue serialises the stages.
+    void filterChain(const uint8_t *src, uint8_t *dst, int width, int height,
+                     const std::vector<int16_t> &taps);
+
+    // Plain transfers of the image buffers, for bandwidth measurements
+    void upload(const uint8_t *src, size_t bytes) override;
+    void download(uint8_t *dst, size_t bytes) override;
+
+    const std::string &bdf() const { return mBdf; } // PCIe address
+    double kernelNs; // accumulated kernel execution time
+
+  private:
+    cl::Context mContext;
+    cl::CommandQueue mQ;
+    cl::Kernel mKrnl;
+    cl::Buffer mImageToDevice;
+    cl::Buffer mImageFromDevice;
+    cl::Buffer mKernelFilterToDevice;
+    f2d::PixelFormat mFormat;
+    std::string mBdf;
+    size_t mMaxPixels; // frame size the buffers were allocated for
+    int16_t mTaps[9];  // coefficients of filterBand()
+};